@@ -0,0 +1,321 @@
+#include <benchmark/benchmark.h>
+
+#include <QApplication>
+#include <QDir>
+#include <QFile>
+#include <QImage>
+#include <QKeyEvent>
+#include <QPainter>
+#include <QStandardItemModel>
+#include <QTabWidget>
+#include <QTemporaryDir>
+#include <QFontDatabase>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "editor/CodeEditor.h"
+#include "editor/Minimap.h"
+#include "logging/VoltLogger.h"
+#include "themes/Theme.h"
+#include "ui/MainWindow.h"
+#include "ui/sidebar/CustomTreeView.h"
+#include "ui/sidebar/ProjectTreeModel.h"
+
+/*
+ * Benchmarks for the editor hot paths, driving the real widgets headlessly.
+ *
+ * Runs on the offscreen platform unless QT_QPA_PLATFORM says otherwise and
+ * prints JSON unless a --benchmark_format is given. Synthetic files are
+ * written once per size into a temporary directory.
+ */
+
+namespace
+{
+QTemporaryDir &benchDir()
+{
+    static QTemporaryDir dir;
+    return dir;
+}
+
+// C++-looking text of the given size, written on first use
+QString syntheticFile(qint64 megabytes)
+{
+    QString path = benchDir().filePath(QString("synthetic_%1mb.cpp").arg(megabytes));
+    if (QFile::exists(path))
+    {
+        return path;
+    }
+
+    QByteArray chunk;
+    for (int line = 0; chunk.size() < 1024 * 1024; ++line)
+    {
+        chunk += "    int value_" + QByteArray::number(line) + " = compute(" + QByteArray::number(line)
+                 + ", \"some text\"); // trailing comment\n";
+    }
+    chunk.truncate(1024 * 1024);
+    chunk[chunk.size() - 1] = '\n';
+
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly))
+    {
+        for (qint64 written = 0; written < megabytes; ++written)
+        {
+            file.write(chunk);
+        }
+    }
+    return path;
+}
+
+void waitForLoads(MainWindow &window)
+{
+    const QList<CodeEditor *> editors = window.findChildren<CodeEditor *>();
+    for (CodeEditor *editor : editors)
+    {
+        while (editor->isLoading())
+        {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+        }
+    }
+    QCoreApplication::processEvents();
+}
+
+CodeEditor *openEditor(MainWindow &window, const QString &path)
+{
+    window.openFile(path);
+    waitForLoads(window);
+    const QList<CodeEditor *> editors = window.findChildren<CodeEditor *>();
+    return editors.isEmpty() ? nullptr : editors.last();
+}
+}
+
+// Open to fully loaded, range is the file size in MB; files past the large file threshold stream in
+static void BM_OpenFile(benchmark::State &state)
+{
+    QString path = syntheticFile(state.range(0));
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto window = std::make_unique<MainWindow>();
+        state.ResumeTiming();
+
+        window->openFile(path);
+        waitForLoads(*window);
+
+        state.PauseTiming();
+        window.reset();
+        QCoreApplication::processEvents();
+        state.ResumeTiming();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 1024 * 1024);
+}
+BENCHMARK(BM_OpenFile)->Arg(1)->Arg(100)->Arg(1024)->Unit(benchmark::kMillisecond);
+
+// One keystroke per iteration through the editor's key handling, including the event loop turn
+static void BM_Typing(benchmark::State &state)
+{
+    MainWindow window;
+    window.resize(1200, 800);
+    window.show();
+    CodeEditor *editor = openEditor(window, syntheticFile(1));
+    if (!editor)
+    {
+        state.SkipWithError("editor did not open");
+        return;
+    }
+    editor->setFocus();
+
+    int column = 0;
+    for (auto _ : state)
+    {
+        bool newline = ++column % 60 == 0;
+        QKeyEvent press(QEvent::KeyPress, newline ? Qt::Key_Return : Qt::Key_A, Qt::NoModifier,
+                        newline ? QString("\r") : QString("a"));
+        QCoreApplication::sendEvent(editor, &press);
+        QCoreApplication::processEvents();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Typing)->Unit(benchmark::kMicrosecond);
+
+// Full minimap rebuild: invalidate, regenerate and wait for every visible tile
+static void BM_MinimapRegenerate(benchmark::State &state)
+{
+    MainWindow window;
+    window.resize(1200, 800);
+    window.show();
+    CodeEditor *editor = openEditor(window, syntheticFile(1));
+    Minimap *minimap = window.findChild<Minimap *>();
+    if (!editor || !minimap)
+    {
+        state.SkipWithError("minimap not created");
+        return;
+    }
+
+    std::atomic<int> rendered{0};
+    QObject::connect(minimap, &Minimap::tileRendered, minimap,
+                     [&rendered](int, quint64, const QImage &) { rendered.fetch_add(1); },
+                     Qt::DirectConnection);
+
+    int totalLines = editor->lines();
+    int visibleLines = qMax(1, minimap->height() / Minimap::LineHeight);
+    int expectedTiles = qMin(visibleLines, qMax(0, totalLines - 1)) / Minimap::TileLines + 1;
+
+    for (auto _ : state)
+    {
+        rendered.store(0);
+        QMetaObject::invokeMethod(minimap, "invalidateAll", Qt::DirectConnection);
+        QMetaObject::invokeMethod(minimap, "doUpdate", Qt::DirectConnection);
+        while (rendered.load() < expectedTiles)
+        {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 1);
+        }
+        QCoreApplication::processEvents();
+    }
+}
+BENCHMARK(BM_MinimapRegenerate)->Unit(benchmark::kMillisecond);
+
+// Theme reload and re-application to every open tab, range is the tab count
+static void BM_ThemeSwitch(benchmark::State &state)
+{
+    MainWindow window;
+    window.resize(1200, 800);
+    window.show();
+    QString source = syntheticFile(1);
+    for (int tab = 0; tab < state.range(0); ++tab)
+    {
+        QString copy = benchDir().filePath(QString("tab_%1.cpp").arg(tab));
+        QFile::copy(source, copy);
+        window.openFile(copy);
+    }
+    waitForLoads(window);
+
+    for (auto _ : state)
+    {
+        Theme::instance().loadTheme("dark");
+        QCoreApplication::processEvents();
+    }
+}
+BENCHMARK(BM_ThemeSwitch)->Arg(1)->Arg(10)->Arg(50)->Unit(benchmark::kMillisecond);
+
+// Activating a tab until it is painted, range is the tab count; should stay flat as it grows
+static void BM_TabSwitch(benchmark::State &state)
+{
+    MainWindow window;
+    window.resize(1200, 800);
+    window.show();
+    QString source = syntheticFile(1);
+    for (int tab = 0; tab < state.range(0); ++tab)
+    {
+        QString copy = benchDir().filePath(QString("tab_%1.cpp").arg(tab));
+        QFile::copy(source, copy);
+        window.openFile(copy);
+    }
+    waitForLoads(window);
+
+    QTabWidget *tabs = window.findChild<QTabWidget *>();
+    if (!tabs || tabs->count() < 2)
+    {
+        state.SkipWithError("not enough tabs");
+        return;
+    }
+
+    //* Alternate between two tabs after a theme change, so each switch also pays for the lazy re-theme *//
+    int index = 0;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        Theme::instance().loadTheme("dark");
+        QCoreApplication::processEvents();
+        state.ResumeTiming();
+
+        index = index == 0 ? 1 : 0;
+        tabs->setCurrentIndex(index);
+        tabs->currentWidget()->repaint();
+    }
+}
+BENCHMARK(BM_TabSwitch)->Arg(2)->Arg(10)->Arg(50)->Arg(200)->Unit(benchmark::kMicrosecond);
+
+// Sidebar row painting, range is the row count
+static void BM_FileItemDelegatePaint(benchmark::State &state)
+{
+    const int rows = int(state.range(0));
+    QStandardItemModel model(rows, 1);
+    for (int row = 0; row < rows; ++row)
+    {
+        bool isDir = row % 10 == 0;
+        QModelIndex index = model.index(row, 0);
+        model.setData(index, isDir ? QString("folder_%1").arg(row) : QString("file_%1.cpp").arg(row), Qt::DisplayRole);
+        model.setData(index, isDir, ProjectTreeModel::IsDirRole);
+    }
+
+    FileItemDelegate delegate;
+    QImage image(300, 22, QImage::Format_ARGB32_Premultiplied);
+    QStyleOptionViewItem option;
+    option.rect = image.rect();
+    option.state = QStyle::State_Enabled;
+
+    for (auto _ : state)
+    {
+        QPainter painter(&image);
+        for (int row = 0; row < rows; ++row)
+        {
+            delegate.paint(&painter, option, model.index(row, 0));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+BENCHMARK(BM_FileItemDelegatePaint)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+// Producer side of the logger, the writer thread drains in the background
+static void BM_LoggerThroughput(benchmark::State &state)
+{
+    int counter = 0;
+    for (auto _ : state)
+    {
+        VOLT_INFO_F("Benchmark record %1 of %2", ++counter, state.thread_index());
+    }
+    VoltLogger::instance().flush();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LoggerThroughput)->Threads(1)->Threads(4);
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    QFontDatabase::addApplicationFont(":/fonts/icons-carbon.ttf");
+
+    VoltLogger &logger = VoltLogger::instance();
+    logger.initialize(benchDir().filePath("volt.log"), VoltLogger::INFO, true, false);
+    //* Measure sustained throughput, not how fast records can be dropped *//
+    logger.setOverflowPolicy(VoltLogger::Block);
+    Theme::instance().loadTheme("dark");
+
+    std::vector<char *> arguments(argv, argv + argc);
+    bool formatGiven = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        formatGiven = formatGiven || QByteArray(argv[i]).startsWith("--benchmark_format");
+    }
+    char jsonFormat[] = "--benchmark_format=json";
+    if (!formatGiven)
+    {
+        arguments.push_back(jsonFormat);
+    }
+    int benchArgc = int(arguments.size());
+
+    benchmark::Initialize(&benchArgc, arguments.data());
+    if (benchmark::ReportUnrecognizedArguments(benchArgc, arguments.data()))
+    {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    logger.shutdown();
+    return 0;
+}
@@ -1,22 +1,32 @@
 #include "CodeEditor.h"
 #include "../themes/Theme.h"
 #include "../logging/VoltLogger.h"
+#include "../logging/VoltTrace.h"
+#include "../logging/PaintStats.h"
 
-CodeEditor::CodeEditor(QWidget *parent)
-    : QsciScintilla(parent), lexer(nullptr), isFileHasUnsavedChanges(false), isLoadingFile(false)
+CodeEditor::CodeEditor(QWidget *parent, bool largeFile)
+    : QsciScintilla(parent), lexer(nullptr), isFileHasUnsavedChanges(false), isLoadingFile(false),
+      largeFileMode(false), pendingLine(-1), pendingColumn(0), appliedThemeGeneration(~quint64(0))
 {
-    Theme::instance().loadTheme("dark");
-
+    //? The theme is loaded once at startup, editors only read it
     setupEditor();
-    applyTheme();
+    if (largeFile)
+    {
+        setLargeFileMode(true);
+    }
+    else
+    {
+        applyTheme();
+    }
 
     //* For updating margin colors on cursor move *//
     connect(this, &QsciScintilla::cursorPositionChanged,
             this, &CodeEditor::updateMarginColors);
 
-    //* Connect to SCN_MODIFIED notification - fires on EVERY text change *//
-    connect(this, SIGNAL(SCN_MODIFIED(int, int, const char*, int, int, int, int, int, int, int)),
-            this, SLOT(onLinesChanged()));
+    //* Scintilla tracks the save point in its undo history, so we only hear about *//
+    //* transitions between "saved" and "modified" instead of every keystroke     *//
+    connect(this, &QsciScintilla::modificationChanged,
+            this, &CodeEditor::onSavePointChanged);
 }
 
 void CodeEditor::setupEditor()
@@ -41,18 +51,32 @@ void CodeEditor::setupEditor()
     setFrameStyle(QFrame::NoFrame);
 }
 
+void CodeEditor::paintEvent(QPaintEvent *event)
+{
+    PaintTimer paintTimer(PaintStats::CodeEditorPaint);
+    QsciScintilla::paintEvent(event);
+}
+
+void CodeEditor::showEvent(QShowEvent *event)
+{
+    //* Hidden editors skip theme changes, they catch up here *//
+    refreshTheme();
+    QsciScintilla::showEvent(event);
+}
+
+/*
+ * Full theme setup: clears the document styling, installs the lexer and
+ * re-lexes the whole document. Only needed once per editor, theme switches
+ * go through refreshTheme().
+ */
 void CodeEditor::applyTheme()
 {
+    VOLT_TRACE_SCOPE("CodeEditor::applyTheme");
     Theme &theme = Theme::instance();
 
     // Get theme colors
     QColor bg = theme.getColor("editor.background");
     QColor fg = theme.getColor("editor.foreground");
-    QColor selectionBg = theme.getColor("editor.selectionBackground");
-    QColor currentLineBg = theme.getColor("editor.currentLine");
-    QColor caretColor = theme.getColor("editor.cursor");
-    QColor matchBrace = theme.getColor("editor.matchingBrace");
-    QColor indentGuide = theme.getColor("editor.indent.guide");
 
     // Get font
     QFont editorFont = theme.getFont("editor");
@@ -68,26 +92,63 @@ void CodeEditor::applyTheme()
     SendScintilla(SCI_STYLESETSIZE, STYLE_DEFAULT, editorFont.pointSize());
     SendScintilla(SCI_STYLECLEARALL);
 
-    setPaper(bg);
-    setColor(fg);
     setFont(editorFont);
 
     // Configure widget background
     setAutoFillBackground(true);
     setAttribute(Qt::WA_OpaquePaintEvent, true);
-    QPalette pal = palette();
-    pal.setColor(QPalette::Base, bg);
-    pal.setColor(QPalette::Window, bg);
-    setPalette(pal);
     setBackgroundRole(QPalette::Base);
 
-    // Apply stylesheet
-    setStyleSheet(QString("QsciScintilla { background-color: %1; border: none; outline: none; }").arg(bg.name()));
-
-    configureLexer();
+    if (!largeFileMode)
+    {
+        configureLexer();
+    }
 
     // Configure margins AFTER lexer is set
     configureMargins();
+    applyEditorColors();
+
+    // Force repaint
+    if (!largeFileMode)
+    {
+        SendScintilla(SCI_COLOURISE, 0, -1);
+    }
+    appliedThemeGeneration = theme.generation();
+    update();
+    emit themeApplied();
+}
+
+/*
+ * Colors that live outside the lexer styles. Shared by the full setup and
+ * the style-only refresh.
+ */
+void CodeEditor::applyEditorColors()
+{
+    Theme &theme = Theme::instance();
+
+    QColor bg = theme.getColor("editor.background");
+    QColor fg = theme.getColor("editor.foreground");
+    QColor selectionBg = theme.getColor("editor.selectionBackground");
+    QColor currentLineBg = theme.getColor("editor.currentLine");
+    QColor caretColor = theme.getColor("editor.cursor");
+    QColor matchBrace = theme.getColor("editor.matchingBrace");
+    QColor indentGuide = theme.getColor("editor.indent.guide");
+
+    setPaper(bg);
+    setColor(fg);
+
+    QPalette pal = palette();
+    pal.setColor(QPalette::Base, bg);
+    pal.setColor(QPalette::Window, bg);
+    setPalette(pal);
+
+    //? Setting a style sheet repolishes the widget, only do it when the color changed
+    QString styleSheet = QString("QsciScintilla { background-color: %1; border: none; outline: none; }").arg(bg.name());
+    if (styleSheet != appliedStyleSheet)
+    {
+        appliedStyleSheet = styleSheet;
+        setStyleSheet(styleSheet);
+    }
 
     // Selection
     setSelectionBackgroundColor(selectionBg);
@@ -109,13 +170,24 @@ void CodeEditor::applyTheme()
     // Indentation guides
     setIndentationGuidesBackgroundColor(bg);
     setIndentationGuidesForegroundColor(indentGuide);
-
-    // Force repaint
-    SendScintilla(SCI_COLOURISE, 0, -1);
-    update();
 }
 
 void CodeEditor::configureLexer()
+{
+    if (!lexer)
+    {
+        lexer = new QsciLexerCPP(this);
+    }
+
+    applyLexerStyles();
+    setLexer(lexer);
+}
+
+/*
+ * Sets the lexer's style attributes. QScintilla forwards each change to the
+ * matching Scintilla style, the styled text itself is left alone.
+ */
+void CodeEditor::applyLexerStyles()
 {
     Theme &theme = Theme::instance();
 
@@ -136,11 +208,6 @@ void CodeEditor::configureLexer()
         editorFont = QFont("Consolas", 10);
     }
 
-    if (!lexer)
-    {
-        lexer = new QsciLexerCPP(this);
-    }
-
     // Set base colors for all styles
     for (int style = 0; style <= 40; ++style)
     {
@@ -198,8 +265,6 @@ void CodeEditor::configureLexer()
     italicFont.setItalic(true);
     lexer->setFont(italicFont, QsciLexerCPP::TaskMarker);
     lexer->setColor(QColor("#d7ba7d"), QsciLexerCPP::EscapeSequence);
-
-    setLexer(lexer);
 }
 
 void CodeEditor::configureMargins()
@@ -241,88 +306,209 @@ void CodeEditor::configureMargins()
 
     // Configure folding
     setFoldMarginColors(marginBg, marginBg);
-    setFolding(QsciScintilla::BoxedTreeFoldStyle);
+    setFolding(largeFileMode ? QsciScintilla::NoFoldStyle : QsciScintilla::BoxedTreeFoldStyle);
     SendScintilla(SCI_SETMARGINBACKN, 2, marginBg.rgb());
 }
 
 void CodeEditor::updateMarginColors()
+{
+    int currentLine, currentCol;
+    getCursorPosition(&currentLine, &currentCol);
+
+    //* Only the caret line's margin style changes, the colors come from STYLE_LINENUMBER *//
+    SendScintilla(SCI_MARGINSETSTYLE, currentLine, STYLE_LINENUMBER);
+}
+
+/*
+ * Style-only theme update for theme switches. The default style, the lexer
+ * styles, margins and editor colors are set in place; unlike applyTheme()
+ * nothing clears the document styling, so no re-lex is needed. Does nothing
+ * when the theme has not changed since the last update, and hidden editors
+ * wait for their next showEvent.
+ */
+void CodeEditor::refreshTheme()
 {
     Theme &theme = Theme::instance();
+    if (appliedThemeGeneration == theme.generation() || !isVisible())
+    {
+        return;
+    }
 
-    QColor marginBg = theme.getColor("editor.lineNumber.background");
-    QColor marginFg = theme.getColor("editor.lineNumber.foreground");
-    QColor currentLineBg = theme.getColor("editor.currentLine");
+    VOLT_TRACE_SCOPE("CodeEditor::refreshTheme");
+    QColor bg = theme.getColor("editor.background");
+    QColor fg = theme.getColor("editor.foreground");
+    QFont editorFont = theme.getFont("editor");
+    if (editorFont.family().isEmpty())
+    {
+        editorFont = QFont("Consolas", 10);
+    }
 
-    int currentLine, currentCol;
-    getCursorPosition(&currentLine, &currentCol);
+    SendScintilla(SCI_STYLESETBACK, STYLE_DEFAULT, bg.rgb());
+    SendScintilla(SCI_STYLESETFORE, STYLE_DEFAULT, fg.rgb());
+    SendScintilla(SCI_STYLESETFONT, STYLE_DEFAULT, editorFont.family().toUtf8().data());
+    SendScintilla(SCI_STYLESETSIZE, STYLE_DEFAULT, editorFont.pointSize());
+    setFont(editorFont);
 
-    // Get total lines for margin width calculation
-    int totalLines = lines();
+    if (lexer && !largeFileMode)
+    {
+        applyLexerStyles();
+    }
+    else
+    {
+        //? Without a lexer every style is a copy of the default, re-copy it; margins are reapplied below
+        SendScintilla(SCI_STYLECLEARALL);
+    }
+    configureMargins();
+    applyEditorColors();
 
-    // Update each line's margin color
-    for (int line = 0; line < totalLines; ++line)
+    appliedThemeGeneration = theme.generation();
+    update();
+    emit themeApplied();
+}
+
+/*
+ * A loader swapped in a new Scintilla document. Lexer state belongs to the
+ * document, so unlike refreshTheme() this always installs the lexer again
+ * and styles the whole text, whatever the theme generation or visibility.
+ */
+void CodeEditor::documentReplaced()
+{
+    if (largeFileMode)
     {
-        if (line == currentLine)
+        return;
+    }
+
+    VOLT_TRACE_SCOPE("CodeEditor::documentReplaced");
+    configureLexer();
+    // Margins AFTER the lexer, like the full setup
+    configureMargins();
+    SendScintilla(SCI_COLOURISE, 0, -1);
+}
+
+void CodeEditor::setLoadingFile(bool loading)
+{
+    bool wasLoading = isLoadingFile;
+    isLoadingFile = loading;
+
+    if (wasLoading && !loading)
+    {
+        emit documentLoaded();
+
+        if (pendingLine >= 0)
         {
-            SendScintilla(SCI_MARGINSETSTYLE, line, STYLE_LINENUMBER);
+            int line = pendingLine;
+            pendingLine = -1;
+            goToLine(line, pendingColumn);
         }
     }
 }
 
-void CodeEditor::refreshTheme()
+void CodeEditor::goToLine(int line, int column)
+{
+    //* The document is swapped in when a background load finishes, positions before that are meaningless *//
+    if (isLoadingFile)
+    {
+        pendingLine = line;
+        pendingColumn = column;
+        return;
+    }
+
+    line = qBound(0, line, qMax(0, lines() - 1));
+    setCursorPosition(line, column);
+
+    //* Center the target line instead of leaving it at the bottom edge *//
+    int onScreen = SendScintilla(SCI_LINESONSCREEN);
+    int visible = SendScintilla(SCI_VISIBLEFROMDOCLINE, static_cast<unsigned long>(line));
+    setFirstVisibleLine(qMax(0, visible - onScreen / 2));
+    setFocus();
+}
+
+/*
+ * Makes this editor a second view of source's document. Scintilla keeps the
+ * text, undo history, save point and style bytes in the document, so nothing
+ * is copied and lexing happens once; this view only adds its own caret,
+ * scroll position and layout cache. Edits and save point changes reach every
+ * view of the document, so the dirty state stays in sync on its own.
+ */
+void CodeEditor::shareDocument(CodeEditor *source)
 {
-    applyTheme();
+    //* Match the source's mode first, large file mode must not install a lexer on the shared document *//
+    setLargeFileMode(source->isLargeFileMode());
+
+    //* SCI_SETDOCPOINTER adds a reference, dropped again when this view is destroyed *//
+    void *document = source->SendScintillaPtrResult(SCI_GETDOCPOINTER);
+    SendScintilla(SCI_SETDOCPOINTER, 0UL, document);
+
+    isFileHasUnsavedChanges = source->hasUnsavedChanges();
+    setFirstVisibleLine(source->firstVisibleLine());
+}
+
+/*
+ * Large file mode is meant for files of hundreds of megabytes and up.
+ * The lexer, folding, brace matching and indentation guides all scan the
+ * document around every change, so they are switched off while it is active.
+ */
+void CodeEditor::setLargeFileMode(bool enabled)
+{
+    if (largeFileMode == enabled)
+    {
+        return;
+    }
+
+    largeFileMode = enabled;
+
+    if (largeFileMode)
+    {
+        setLexer(nullptr);
+        setFolding(QsciScintilla::NoFoldStyle);
+        setBraceMatching(QsciScintilla::NoBraceMatch);
+        setIndentationGuides(false);
+        setWrapMode(QsciScintilla::WrapNone);
+        //? Dropping the lexer resets every style, theme the default style and margins again
+        applyTheme();
+        VOLT_INFO("[EDITOR] Large file mode enabled");
+    }
+    else
+    {
+        setBraceMatching(QsciScintilla::SloppyBraceMatch);
+        setIndentationGuides(true);
+        applyTheme();
+    }
 }
 
 void CodeEditor::markAsSaved()
 {
     isFileHasUnsavedChanges = false;
-    lastSavedContent = text();
+
+    //* Move Scintilla's save point to the current undo position *//
+    SendScintilla(SCI_SETSAVEPOINT);
     emit fileModificationChanged(false);
 }
 
 /*
- * Detects ANY text change (every keystroke, paste, delete, etc.)
- * Emits signal to MainWindow to update tab title with asterisk (*)
+ * Slot for modificationChanged signal (SCN_SAVEPOINTLEFT / SCN_SAVEPOINTREACHED)
+ * Fires only when the document leaves or returns to the save point, e.g. on the
+ * first edit after a save, or when undo brings the text back to the saved state.
+ * The cost is independent of document size, unlike comparing the full text.
  */
-/*
- * Slot for linesChanged signal
- * This fires whenever lines are added, deleted, or modified in the document
- * This is the most reliable way to detect text changes in QScintilla
- */
-void CodeEditor::onLinesChanged()
+void CodeEditor::onSavePointChanged(bool modified)
 {
-    
     if (isLoadingFile)
     {
-        VOLT_DEBUG("[EDITOR] Ignoring text change - file is being loaded");
+        VOLT_DEBUG("[EDITOR] Ignoring save point change - file is being loaded");
         return;
     }
 
-    /* 
-        * Compare current content with saved content.
-        * If they match, clear the unsaved changes flag.
-        * If they differ, set the unsaved changes flag.
-        ! NOTE: If performance becomes an issue, consider optimizing this by tracking changes incrementally. 
-    */
-    QString currentContent = text();
-    bool contentMatches = (currentContent == lastSavedContent);
-    
-    if (contentMatches)
+    if (modified == isFileHasUnsavedChanges)
     {
-        if (isFileHasUnsavedChanges)
-        {
-            isFileHasUnsavedChanges = false;
-            emit fileModificationChanged(false);
-            VOLT_INFO("[EDITOR] ✓ Content restored to saved state - removing asterisk");
-        }
+        return;
     }
-    else
+
+    isFileHasUnsavedChanges = modified;
+    emit fileModificationChanged(modified);
+
+    if (!modified)
     {
-        if (!isFileHasUnsavedChanges)
-        {
-            isFileHasUnsavedChanges = true;
-            emit fileModificationChanged(true);
-        }
+        VOLT_INFO("[EDITOR] ✓ Content restored to saved state - removing asterisk");
     }
-}
\ No newline at end of file
+}
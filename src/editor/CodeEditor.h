@@ -8,29 +8,56 @@ class CodeEditor : public QsciScintilla
 {
     Q_OBJECT
 public:
-    explicit CodeEditor(QWidget *parent = nullptr);
+    // A large file editor starts without a lexer, so the first theming already skips it
+    explicit CodeEditor(QWidget *parent = nullptr, bool largeFile = false);
     bool hasUnsavedChanges() const { return isFileHasUnsavedChanges; }
     void markAsSaved();
-    void setLoadingFile(bool loading) { isLoadingFile = loading; }
+    void setLoadingFile(bool loading);
+    bool isLoading() const { return isLoadingFile; }
+
+    // Large file mode trades lexing, folding and other per-line features for responsiveness
+    void setLargeFileMode(bool enabled);
+    bool isLargeFileMode() const { return largeFileMode; }
+
+    // Moves the caret to a zero-based line and column, deferred until a running load finishes
+    void goToLine(int line, int column = 0);
+
+    // Turns this editor into another view of source's document, for split editors
+    void shareDocument(CodeEditor *source);
+    // Sets the lexer up again after a new Scintilla document was swapped in
+    void documentReplaced();
 
 signals:
     void fileModificationChanged(bool hasChanges);
+    void documentLoaded();
+    // Styles now match the current theme, emitted after applyTheme() and refreshTheme()
+    void themeApplied();
 
 public slots:
     void applyTheme();
     void refreshTheme();
 
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+
 private slots:
     void updateMarginColors();
-    void onLinesChanged();
+    void onSavePointChanged(bool modified);
 
 private:
     void setupEditor();
     void configureMargins();
     void configureLexer();
+    void applyLexerStyles();
+    void applyEditorColors();
 
     QsciLexerCPP *lexer;
     bool isFileHasUnsavedChanges;
     bool isLoadingFile;
-    QString lastSavedContent;
+    bool largeFileMode;
+    int pendingLine;
+    int pendingColumn;
+    quint64 appliedThemeGeneration;
+    QString appliedStyleSheet;
 };
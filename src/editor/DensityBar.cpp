@@ -0,0 +1,122 @@
+#include "DensityBar.h"
+#include "CodeEditor.h"
+#include <Qsci/qsciscintilla.h>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QMouseEvent>
+#include <QScrollBar>
+
+namespace {
+//* Lines at least this long are drawn at full width *//
+constexpr int FullLineLength = 160;
+}
+
+DensityBar::DensityBar(CodeEditor *editor, QWidget *parent)
+    : QWidget(parent), m_editor(editor)
+{
+    setFixedWidth(40);
+    setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Expanding);
+
+    m_updateTimer.setSingleShot(true);
+    m_updateTimer.setInterval(250);
+
+    connect(&m_updateTimer, &QTimer::timeout, this, &DensityBar::resample);
+
+    connect(m_editor, SIGNAL(textChanged()), this, SLOT(scheduleUpdate()));
+    connect(m_editor, &CodeEditor::documentLoaded, this, &DensityBar::scheduleUpdate);
+    if (m_editor->verticalScrollBar()) {
+        connect(m_editor->verticalScrollBar(), &QScrollBar::valueChanged, this, qOverload<>(&QWidget::update));
+    }
+
+    scheduleUpdate();
+}
+
+QSize DensityBar::sizeHint() const
+{
+    return QSize(40, 200);
+}
+
+void DensityBar::scheduleUpdate()
+{
+    if (!m_updateTimer.isActive()) m_updateTimer.start();
+}
+
+void DensityBar::resample()
+{
+    int rows = height();
+    int totalLines = m_editor->SendScintilla(QsciScintillaBase::SCI_GETLINECOUNT, 0UL, 0L);
+
+    m_density.fill(0, qMax(0, rows));
+    if (rows <= 0 || totalLines <= 0) {
+        update();
+        return;
+    }
+
+    for (int y = 0; y < rows; ++y) {
+        int line = int(qint64(y) * totalLines / rows);
+        int length = m_editor->SendScintilla(QsciScintillaBase::SCI_LINELENGTH, static_cast<unsigned long>(line), 0L);
+        m_density[y] = quint8(qMin(length, FullLineLength) * 255 / FullLineLength);
+    }
+
+    update();
+}
+
+void DensityBar::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    QPainter p(this);
+    QPalette pal = m_editor->palette();
+    p.fillRect(rect(), pal.color(QPalette::Base));
+
+    QColor barColor = pal.color(QPalette::Text);
+    barColor.setAlpha(90);
+
+    int w = width() - 4;
+    for (int y = 0; y < m_density.size(); ++y) {
+        if (m_density[y] == 0) continue;
+        p.fillRect(2, y, qMax(1, w * m_density[y] / 255), 1, barColor);
+    }
+
+    QRectF vp = viewportRect();
+    if (!vp.isNull()) {
+        p.fillRect(vp, QColor(200, 200, 200, 40));
+    }
+}
+
+QRectF DensityBar::viewportRect() const
+{
+    int firstLine = m_editor->SendScintilla(QsciScintillaBase::SCI_GETFIRSTVISIBLELINE, 0UL, 0L);
+    int visibleLines = m_editor->SendScintilla(QsciScintillaBase::SCI_LINESONSCREEN, 0UL, 0L);
+    int totalLines = m_editor->SendScintilla(QsciScintillaBase::SCI_GETLINECOUNT, 0UL, 0L);
+    if (totalLines <= 0) return QRectF();
+
+    qreal y = (firstLine / (qreal)totalLines) * height();
+    qreal h = (visibleLines / (qreal)totalLines) * height();
+    return QRectF(0, y, width(), qMax<qreal>(2.0, h));
+}
+
+void DensityBar::resizeEvent(QResizeEvent *event)
+{
+    Q_UNUSED(event);
+    scheduleUpdate();
+}
+
+void DensityBar::mousePressEvent(QMouseEvent *event)
+{
+    if (height() <= 0) return;
+
+    qreal ratio = qBound<qreal>(0.0, event->position().y() / qreal(height()), 1.0);
+    int totalLines = m_editor->SendScintilla(QsciScintillaBase::SCI_GETLINECOUNT, 0UL, 0L);
+    int visible = m_editor->SendScintilla(QsciScintillaBase::SCI_LINESONSCREEN, 0UL, 0L);
+    int targetLine = qBound(0, int(ratio * totalLines), qMax(0, totalLines - 1));
+
+    int first = qMax(0, targetLine - visible / 2);
+    m_editor->SendScintilla(QsciScintillaBase::SCI_SETFIRSTVISIBLELINE, static_cast<unsigned long>(first));
+}
+
+void DensityBar::mouseMoveEvent(QMouseEvent *event)
+{
+    if (event->buttons() & Qt::LeftButton) {
+        mousePressEvent(event);
+    }
+}
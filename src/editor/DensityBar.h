@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QWidget>
+#include <QTimer>
+#include <QVector>
+#include <QRectF>
+
+class CodeEditor;
+
+/*
+ * Lightweight stand-in for the Minimap used by editors in large file mode.
+ * Each pixel row shows how long the lines under it are, sampled from
+ * Scintilla's line index, so the cost depends on the widget height only.
+ */
+class DensityBar : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit DensityBar(CodeEditor *editor, QWidget *parent = nullptr);
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+
+private slots:
+    void scheduleUpdate();
+    void resample();
+
+private:
+    QRectF viewportRect() const;
+
+    CodeEditor *m_editor;
+    QTimer m_updateTimer;
+    QVector<quint8> m_density;
+};
@@ -0,0 +1,223 @@
+#include "DocumentRegistry.h"
+#include "../logging/VoltLogger.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+struct DocumentRegistry::FileIdentity
+{
+    QString canonicalPath;
+    QString fileId;
+    qint64 size = -1;
+    qint64 modified = -1;
+};
+
+/*
+ * Canonical path (symlinks resolved, or the cleaned absolute path for a file
+ * that does not exist yet) plus the device, inode, size and modification
+ * time where the platform has them. Windows paths compare case-insensitively,
+ * so they are folded.
+ */
+DocumentRegistry::FileIdentity DocumentRegistry::identify(const QString &filePath)
+{
+    FileIdentity identity;
+    QFileInfo info(filePath);
+    identity.canonicalPath = info.canonicalFilePath();
+    if (identity.canonicalPath.isEmpty())
+    {
+        identity.canonicalPath = QDir::cleanPath(info.absoluteFilePath());
+    }
+#ifdef Q_OS_WIN
+    identity.canonicalPath = identity.canonicalPath.toCaseFolded();
+#endif
+
+#ifdef Q_OS_UNIX
+    struct stat st;
+    if (::stat(QFile::encodeName(filePath).constData(), &st) == 0)
+    {
+        identity.fileId = QString("%1:%2").arg(quint64(st.st_dev)).arg(quint64(st.st_ino));
+        identity.size = qint64(st.st_size);
+        identity.modified = qint64(st.st_mtime);
+    }
+#endif
+    return identity;
+}
+
+DocumentRegistry::DocumentRegistry(QObject *parent) : QObject(parent)
+{
+}
+
+DocumentRegistry::~DocumentRegistry()
+{
+    qDeleteAll(m_byTab);
+}
+
+/*
+ * By canonical path first, which also catches a file replaced by a new inode
+ * (an atomic save from another program) and refreshes the stored id. Then by
+ * inode, so a moved file is found under its new path. Inodes are reused after
+ * a delete and shared by hard links, so an inode match only counts as a move
+ * when the document's old path is gone and size and modification time are
+ * unchanged; anything else is a different file and gets its own document.
+ */
+DocumentRegistry::Document *DocumentRegistry::find(const QString &filePath)
+{
+    if (filePath.isEmpty())
+    {
+        return nullptr;
+    }
+
+    FileIdentity identity = identify(filePath);
+    if (Document *document = m_byPath.value(identity.canonicalPath))
+    {
+        if (document->fileId != identity.fileId)
+        {
+            update(document, identity);
+        }
+        return document;
+    }
+
+    if (identity.fileId.isEmpty())
+    {
+        return nullptr;
+    }
+
+    Document *document = m_byFileId.value(identity.fileId);
+    if (!document || QFileInfo::exists(document->path) || document->size != identity.size
+        || document->modified != identity.modified)
+    {
+        return nullptr;
+    }
+
+    VOLT_INFO_F2("Open file moved from %1 to %2", document->path, filePath);
+    relocate(document, filePath);
+    return document;
+}
+
+QString DocumentRegistry::pathOf(CodeEditor *editor) const
+{
+    Document *document = forEditor(editor);
+    return document ? document->path : QString();
+}
+
+DocumentRegistry::Document *DocumentRegistry::add(const QString &filePath, QWidget *tab)
+{
+    FileIdentity identity = identify(filePath);
+
+    Document *document = new Document;
+    document->path = filePath;
+    document->tab = tab;
+    update(document, identity);
+
+    m_byTab.insert(tab, document);
+    return document;
+}
+
+//* Called before the tab's widgets are deleted, so a reopen cannot hit a dying editor *//
+void DocumentRegistry::removeTab(QWidget *tab)
+{
+    Document *document = m_byTab.take(tab);
+    if (!document)
+    {
+        return;
+    }
+
+    for (CodeEditor *editor : document->editors)
+    {
+        m_byEditor.remove(editor);
+    }
+    unindex(document);
+    delete document;
+}
+
+void DocumentRegistry::addView(Document *document, CodeEditor *editor)
+{
+    document->editors.append(editor);
+    m_byEditor.insert(editor, document);
+}
+
+void DocumentRegistry::removeView(CodeEditor *editor)
+{
+    Document *document = forEditor(editor);
+    if (!document || document->editors.first() == editor)
+    {
+        return;
+    }
+
+    document->editors.removeOne(editor);
+    m_byEditor.remove(editor);
+}
+
+QList<CodeEditor *> DocumentRegistry::clearViews(Document *document)
+{
+    const QList<CodeEditor *> views = document->editors;
+    for (CodeEditor *view : views)
+    {
+        m_byEditor.remove(view);
+    }
+    document->editors.clear();
+    return views;
+}
+
+void DocumentRegistry::setPath(CodeEditor *editor, const QString &filePath)
+{
+    if (Document *document = forEditor(editor))
+    {
+        relocate(document, filePath);
+    }
+}
+
+//* The file was written in place, its size and modification time are recorded again *//
+void DocumentRegistry::refresh(CodeEditor *editor)
+{
+    if (Document *document = forEditor(editor))
+    {
+        update(document, identify(document->path));
+    }
+}
+
+void DocumentRegistry::relocate(Document *document, const QString &filePath)
+{
+    document->path = filePath;
+    update(document, identify(filePath));
+    emit pathChanged(document);
+}
+
+void DocumentRegistry::update(Document *document, const FileIdentity &identity)
+{
+    unindex(document);
+    document->canonicalPath = identity.canonicalPath;
+    document->fileId = identity.fileId;
+    if (identity.size >= 0)
+    {
+        document->size = identity.size;
+    }
+    document->modified = identity.modified;
+    index(document);
+}
+
+//? A later document with the same key takes over the lookup, the earlier one stays open but unindexed
+void DocumentRegistry::index(Document *document)
+{
+    m_byPath.insert(document->canonicalPath, document);
+    if (!document->fileId.isEmpty())
+    {
+        m_byFileId.insert(document->fileId, document);
+    }
+}
+
+void DocumentRegistry::unindex(Document *document)
+{
+    if (m_byPath.value(document->canonicalPath) == document)
+    {
+        m_byPath.remove(document->canonicalPath);
+    }
+    if (!document->fileId.isEmpty() && m_byFileId.value(document->fileId) == document)
+    {
+        m_byFileId.remove(document->fileId);
+    }
+}
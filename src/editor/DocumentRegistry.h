@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+class CodeEditor;
+class QWidget;
+
+/*
+ * The open documents of a window, the single place that knows which file
+ * an editor and its tab belong to.
+ *
+ * A file is identified by its device and inode (on Unix) and by its
+ * canonical path, both in hash maps, so a lookup is one stat and two hash
+ * probes however many tabs are open. Two files with the same name never
+ * alias, and a file moved on disk is still recognised by its inode when it
+ * is opened again from the new location, as long as its size and
+ * modification time are unchanged; the document's path follows it.
+ */
+class DocumentRegistry : public QObject
+{
+    Q_OBJECT
+public:
+    struct Document
+    {
+        QString path;
+        QString canonicalPath;
+        QString fileId;
+        QWidget *tab = nullptr;
+        // Empty while the tab is a placeholder
+        QList<CodeEditor *> editors;
+        qint64 size = 0;
+        // Seconds since the epoch, with size it tells a moved file from a reused inode
+        qint64 modified = -1;
+        quint64 lastShown = 0;
+    };
+
+    explicit DocumentRegistry(QObject *parent = nullptr);
+    ~DocumentRegistry();
+
+    // The open document for a file, nullptr if it is not open
+    Document *find(const QString &filePath);
+    Document *forEditor(CodeEditor *editor) const { return m_byEditor.value(editor); }
+    Document *forTab(QWidget *tab) const { return m_byTab.value(tab); }
+
+    QString pathOf(CodeEditor *editor) const;
+
+    // Registers a tab for the file, its editors are added with addView
+    Document *add(const QString &filePath, QWidget *tab);
+    void removeTab(QWidget *tab);
+
+    // Views of an open document; removeView never removes the first one
+    void addView(Document *document, CodeEditor *editor);
+    void removeView(CodeEditor *editor);
+    // Back to a placeholder, returns the views that were dropped
+    QList<CodeEditor *> clearViews(Document *document);
+
+    // Save As: the document now lives at filePath
+    void setPath(CodeEditor *editor, const QString &filePath);
+    // Save: the file was written in place
+    void refresh(CodeEditor *editor);
+
+    int count() const { return m_byTab.size(); }
+    QList<Document *> all() const { return m_byTab.values(); }
+
+signals:
+    void pathChanged(DocumentRegistry::Document *document);
+
+private:
+    struct FileIdentity;
+    static FileIdentity identify(const QString &filePath);
+    void update(Document *document, const FileIdentity &identity);
+    void index(Document *document);
+    void unindex(Document *document);
+    void relocate(Document *document, const QString &filePath);
+
+    QHash<QString, Document *> m_byFileId;
+    QHash<QString, Document *> m_byPath;
+    QHash<CodeEditor *, Document *> m_byEditor;
+    QHash<QWidget *, Document *> m_byTab;
+};
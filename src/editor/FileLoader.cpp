@@ -0,0 +1,276 @@
+#include "FileLoader.h"
+#include "CodeEditor.h"
+#include "../logging/VoltLogger.h"
+#include <QThread>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#ifdef _WIN32
+#define VOLT_SCI_METHOD __stdcall
+#else
+#define VOLT_SCI_METHOD
+#endif
+
+namespace {
+
+/*
+ * Mirrors Scintilla's include/ILoader.h, which QScintilla does not install.
+ * The object returned by SCI_CREATELOADER is a document that is not attached
+ * to any view, so it may be filled from a worker thread.
+ */
+class ILoader
+{
+public:
+    virtual int VOLT_SCI_METHOD Release() = 0;
+    virtual int VOLT_SCI_METHOD AddData(const char *data, std::ptrdiff_t length) = 0;
+    virtual void *VOLT_SCI_METHOD ConvertToDocument() = 0;
+};
+
+using SciDirectFunction = std::intptr_t (*)(std::intptr_t, unsigned int, std::uintptr_t, std::intptr_t);
+
+/*
+ * SendScintilla() returns a long, which truncates pointers on 64-bit Windows.
+ * The direct function returns the full pointer-sized result.
+ */
+void *createLoader(CodeEditor *editor, qint64 bytes, int documentOptions)
+{
+    auto fn = reinterpret_cast<SciDirectFunction>(
+        editor->SendScintillaPtrResult(QsciScintillaBase::SCI_GETDIRECTFUNCTION));
+    auto ptr = reinterpret_cast<std::intptr_t>(
+        editor->SendScintillaPtrResult(QsciScintillaBase::SCI_GETDIRECTPOINTER));
+    if (!fn || !ptr)
+    {
+        return nullptr;
+    }
+
+    return reinterpret_cast<void *>(fn(ptr, QsciScintillaBase::SCI_CREATELOADER,
+                                       static_cast<std::uintptr_t>(bytes), documentOptions));
+}
+
+}
+
+FileLoader::FileLoader(CodeEditor *editor, const QString &filePath, QObject *parent)
+    : QObject(parent), m_editor(editor), m_filePath(filePath), m_file(filePath),
+      m_data(nullptr), m_size(0), m_loader(nullptr), m_thread(nullptr),
+      m_cancelled(false), m_lastPercent(-1)
+{
+}
+
+FileLoader::~FileLoader()
+{
+    cancel();
+    if (m_thread)
+    {
+        m_thread->wait();
+        delete m_thread;
+    }
+    if (m_loader)
+    {
+        static_cast<ILoader *>(m_loader)->Release();
+    }
+    unmap();
+}
+
+bool FileLoader::open()
+{
+    if (!m_file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    m_size = m_file.size();
+    if (m_size == 0)
+    {
+        return true;
+    }
+
+    m_data = m_file.map(0, m_size);
+    if (!m_data)
+    {
+        VOLT_ERROR_F("FileLoader: cannot map %1", m_filePath);
+        m_file.close();
+        return false;
+    }
+    return true;
+}
+
+void FileLoader::start()
+{
+    if (m_size <= BackgroundThreshold)
+    {
+        loadSynchronously();
+        return;
+    }
+
+    //* Documents beyond 2 GB need 64-bit positions *//
+    int documentOptions = m_size > std::numeric_limits<int>::max()
+                              ? QsciScintillaBase::SC_DOCUMENTOPTION_TEXT_LARGE
+                              : QsciScintillaBase::SC_DOCUMENTOPTION_DEFAULT;
+
+    //* Without a lexer there is nothing to style, so skip the per-byte style buffer *//
+    if (m_editor->isLargeFileMode())
+    {
+        documentOptions |= QsciScintillaBase::SC_DOCUMENTOPTION_STYLES_NONE;
+    }
+
+    m_loader = createLoader(m_editor, m_size, documentOptions);
+    if (!m_loader)
+    {
+        VOLT_WARN_F("FileLoader: SCI_CREATELOADER unavailable, loading %1 on the GUI thread", m_filePath);
+        loadSynchronously();
+        return;
+    }
+
+    //* The editor keeps showing its empty document until the loaded one is swapped in *//
+    m_editor->setReadOnly(true);
+
+    m_thread = QThread::create([this]() { runWorker(); });
+    m_thread->setObjectName("FileLoader");
+    m_thread->start(QThread::LowPriority);
+}
+
+void FileLoader::cancel()
+{
+    m_cancelled.store(true);
+}
+
+void FileLoader::loadSynchronously()
+{
+    //? Appending the file must not create undo actions
+    m_editor->SendScintilla(QsciScintillaBase::SCI_SETUNDOCOLLECTION, 0UL);
+    m_editor->SendScintilla(QsciScintillaBase::SCI_CLEARALL);
+    m_editor->SendScintilla(QsciScintillaBase::SCI_ALLOCATE, static_cast<unsigned long>(m_size + 1));
+
+    qint64 offset = 0;
+    while (offset < m_size)
+    {
+        qint64 length = qMin(ChunkSize, m_size - offset);
+        m_editor->SendScintilla(QsciScintillaBase::SCI_APPENDTEXT,
+                                static_cast<uintptr_t>(length),
+                                reinterpret_cast<const char *>(m_data + offset));
+        offset += length;
+        reportProgress(offset);
+    }
+
+    m_editor->SendScintilla(QsciScintillaBase::SCI_SETUNDOCOLLECTION, 1UL);
+    m_editor->SendScintilla(QsciScintillaBase::SCI_EMPTYUNDOBUFFER);
+    applyEolMode();
+    unmap();
+
+    emit finished(true);
+}
+
+/*
+ * Runs on the worker thread. Only the detached ILoader document is touched
+ * here, the editor itself belongs to the GUI thread.
+ */
+void FileLoader::runWorker()
+{
+    ILoader *loader = static_cast<ILoader *>(m_loader);
+    bool success = true;
+
+    qint64 offset = 0;
+    while (offset < m_size)
+    {
+        if (m_cancelled.load())
+        {
+            success = false;
+            break;
+        }
+
+        qint64 length = qMin(ChunkSize, m_size - offset);
+        if (loader->AddData(reinterpret_cast<const char *>(m_data + offset), length) != QsciScintillaBase::SC_STATUS_OK)
+        {
+            success = false;
+            break;
+        }
+        offset += length;
+        reportProgress(offset);
+    }
+
+    QMetaObject::invokeMethod(this, "onWorkerFinished", Qt::QueuedConnection, Q_ARG(bool, success));
+}
+
+void FileLoader::onWorkerFinished(bool success)
+{
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+
+    ILoader *loader = static_cast<ILoader *>(m_loader);
+    m_loader = nullptr;
+
+    if (!success || m_cancelled.load())
+    {
+        loader->Release();
+        unmap();
+        m_editor->setReadOnly(false);
+        emit finished(false);
+        return;
+    }
+
+    //* SCI_SETDOCPOINTER takes its own reference, drop the one from the loader *//
+    void *document = loader->ConvertToDocument();
+    m_editor->SendScintilla(QsciScintillaBase::SCI_SETDOCPOINTER, 0UL, document);
+    m_editor->SendScintilla(QsciScintillaBase::SCI_RELEASEDOCUMENT, 0UL, document);
+    m_editor->setReadOnly(false);
+
+    //? Loader documents start with undo collection off; without it edits never leave the save point
+    m_editor->SendScintilla(QsciScintillaBase::SCI_SETUNDOCOLLECTION, 1UL);
+    m_editor->SendScintilla(QsciScintillaBase::SCI_EMPTYUNDOBUFFER);
+
+    // Lexer state lives in the document, so the lexer is installed again and the new text styled
+    m_editor->documentReplaced();
+    applyEolMode();
+    unmap();
+
+    emit finished(true);
+}
+
+void FileLoader::reportProgress(qint64 bytesLoaded)
+{
+    int percent = m_size > 0 ? int(bytesLoaded * 100 / m_size) : 100;
+    if (percent != m_lastPercent)
+    {
+        m_lastPercent = percent;
+        emit progressChanged(percent);
+    }
+}
+
+/*
+ * The raw bytes are loaded without newline translation, so new lines typed by
+ * the user should use the same line ending as the first line of the file.
+ */
+void FileLoader::applyEolMode()
+{
+    if (!m_data || m_size == 0)
+    {
+        return;
+    }
+
+    qint64 scan = qMin<qint64>(m_size, 64 * 1024);
+    const void *newline = std::memchr(m_data, '\n', size_t(scan));
+    if (!newline)
+    {
+        return;
+    }
+
+    const uchar *lf = static_cast<const uchar *>(newline);
+    bool crlf = lf > m_data && *(lf - 1) == '\r';
+    m_editor->SendScintilla(QsciScintillaBase::SCI_SETEOLMODE,
+                            static_cast<unsigned long>(crlf ? QsciScintillaBase::SC_EOL_CRLF : QsciScintillaBase::SC_EOL_LF));
+}
+
+void FileLoader::unmap()
+{
+    if (m_data)
+    {
+        m_file.unmap(const_cast<uchar *>(m_data));
+        m_data = nullptr;
+    }
+    if (m_file.isOpen())
+    {
+        m_file.close();
+    }
+}
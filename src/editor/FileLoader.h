@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QObject>
+#include <QFile>
+#include <QString>
+#include <atomic>
+
+class CodeEditor;
+class QThread;
+
+/*
+ * Streams a file from disk into a CodeEditor.
+ *
+ * The file is memory-mapped instead of being decoded into a QString, so the
+ * bytes are copied exactly once, straight into the Scintilla document.
+ * Small files are appended on the GUI thread in bounded chunks. Larger files
+ * are fed to a detached Scintilla document (ILoader) on a worker thread and
+ * swapped into the editor once complete, so the UI stays responsive and the
+ * tab is usable while the load is in progress.
+ */
+class FileLoader : public QObject
+{
+    Q_OBJECT
+public:
+    explicit FileLoader(CodeEditor *editor, const QString &filePath, QObject *parent = nullptr);
+    ~FileLoader();
+
+    // Opens and maps the file, returns false if it cannot be read
+    bool open();
+    // Starts streaming the mapped file into the editor
+    void start();
+    void cancel();
+
+    QString filePath() const { return m_filePath; }
+    QString errorString() const { return m_file.errorString(); }
+
+    //* Files up to this size are loaded on the GUI thread *//
+    static constexpr qint64 BackgroundThreshold = 8 * 1024 * 1024;
+    //* Upper bound for a single SCI_APPENDTEXT / ILoader::AddData call *//
+    static constexpr qint64 ChunkSize = 4 * 1024 * 1024;
+
+signals:
+    void progressChanged(int percent);
+    void finished(bool success);
+
+private slots:
+    void onWorkerFinished(bool success);
+
+private:
+    void loadSynchronously();
+    void runWorker();
+    void reportProgress(qint64 bytesLoaded);
+    void applyEolMode();
+    void unmap();
+
+    CodeEditor *m_editor;
+    QString m_filePath;
+    QFile m_file;
+    const uchar *m_data;
+    qint64 m_size;
+    void *m_loader;
+    QThread *m_thread;
+    std::atomic<bool> m_cancelled;
+    int m_lastPercent;
+};
@@ -1,16 +1,68 @@
 #include "Minimap.h"
 #include "CodeEditor.h"
+#include "../logging/VoltTrace.h"
+#include "../logging/PaintStats.h"
 #include <Qsci/qsciscintilla.h>
 #include <QPainter>
 #include <QPaintEvent>
 #include <QMouseEvent>
 #include <QScrollBar>
-#include <QFontMetrics>
-#include <QDebug>
+#include <QImage>
+#include <climits>
+
+struct MinimapRun
+{
+    quint16 row;
+    quint16 column;
+    quint16 length;
+    quint8 style;
+};
+
+struct MinimapTileSnapshot
+{
+    int tile = 0;
+    quint64 generation = 0;
+    int width = 0;
+    qreal devicePixelRatio = 1.0;
+    QColor background;
+    QVector<QColor> palette;
+    QVector<MinimapRun> runs;
+};
+
+namespace {
+//* Tiles kept around the visible window so short scrolls don't re-render *//
+constexpr int TileMargin = 2;
+
+/*
+ * Every run of non-blank characters sharing a style becomes one rectangle.
+ * Only touches the snapshot, so it is safe to call from the render thread.
+ */
+QImage rasterizeTile(const MinimapTileSnapshot &snapshot)
+{
+    QImage image(QSize(snapshot.width, Minimap::TileLines * Minimap::LineHeight) * snapshot.devicePixelRatio,
+                 QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(snapshot.devicePixelRatio);
+    image.fill(snapshot.background);
+
+    QPainter p(&image);
+    for (const MinimapRun &run : snapshot.runs) {
+        p.fillRect(run.column * Minimap::CharWidth, run.row * Minimap::LineHeight,
+                   run.length * Minimap::CharWidth, Minimap::LineHeight, snapshot.palette[run.style]);
+    }
+    p.end();
+
+    return image;
+}
+}
 
 Minimap::Minimap(CodeEditor *editor, QWidget *parent)
-    : QWidget(parent), m_editor(editor), m_scale(0.0)
+    : QWidget(parent), m_editor(editor), m_generationCounter(0), m_tileDpr(1.0), m_rendering(false),
+      m_lastFirstLine(-1), m_dragOffset(-1)
 {
+    //* One render thread per minimap keeps tiles of the same editor in order *//
+    m_renderPool.setMaxThreadCount(1);
+    connect(this, &Minimap::tileRendered, this, &Minimap::onTileRendered, Qt::QueuedConnection);
+
     setMinimumWidth(80);
     setMaximumWidth(240);
     setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Expanding);
@@ -20,15 +72,28 @@ Minimap::Minimap(CodeEditor *editor, QWidget *parent)
 
     connect(&m_updateTimer, &QTimer::timeout, this, &Minimap::doUpdate);
 
-    connect(m_editor, SIGNAL(cursorPositionChanged(int,int)), this, SLOT(scheduleUpdate()));
-    connect(m_editor, SIGNAL(textChanged()), this, SLOT(scheduleUpdate()));
+    //* Moving around the document only moves the overlay, the tiles stay valid *//
+    connect(m_editor, SIGNAL(cursorPositionChanged(int,int)), this, SLOT(onViewportChanged()));
+    connect(m_editor, SIGNAL(SCN_MODIFIED(int,int,const char*,int,int,int,int,int,int,int)),
+            this, SLOT(onDocumentModified(int,int,const char*,int,int,int,int,int,int,int)));
+    connect(m_editor, &CodeEditor::documentLoaded, this, &Minimap::invalidateAll);
+    //* The palette is read back from the editor's styles, so wait for the editor to apply the theme; *//
+    //* a hidden editor only does that in its showEvent                                             *//
+    connect(m_editor, &CodeEditor::themeApplied, this, &Minimap::invalidateAll);
     if (m_editor->verticalScrollBar()) {
-        connect(m_editor->verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(scheduleUpdate()));
+        connect(m_editor->verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(onViewportChanged()));
     }
 
     scheduleUpdate();
 }
 
+Minimap::~Minimap()
+{
+    //* Render jobs emit through this object, let them finish before it goes away *//
+    m_renderPool.clear();
+    m_renderPool.waitForDone();
+}
+
 QSize Minimap::sizeHint() const
 {
     return QSize(100, 200);
@@ -45,123 +110,398 @@ void Minimap::doUpdate()
     update();
 }
 
+void Minimap::invalidateAll()
+{
+    m_tiles.clear();
+    m_dirtyTiles.clear();
+    m_tileGenerations.clear();
+    m_pendingTiles.clear();
+    m_stylePalette.clear();
+    scheduleUpdate();
+}
+
+/*
+ * Repaints only what a scroll changed. While the minimap window stays at the
+ * same first line, that is the old and the new overlay rectangle. Once the
+ * window moves, the cached tiles are blitted at their new offset and any tile
+ * that scrolled in is requested from the render thread by paintEvent.
+ */
+void Minimap::onViewportChanged()
+{
+    int first = firstMinimapLine();
+    QRect overlay = viewportRectOnMinimap().toAlignedRect().adjusted(-1, -1, 1, 1);
+
+    if (first != m_lastFirstLine) {
+        m_lastFirstLine = first;
+        update();
+    } else if (overlay != m_lastOverlay) {
+        update(m_lastOverlay.united(overlay));
+    }
+    m_lastOverlay = overlay;
+}
+
+void Minimap::invalidateTile(int tile)
+{
+    m_dirtyTiles.insert(tile);
+    m_tileGenerations.insert(tile, ++m_generationCounter);
+}
+
+quint64 Minimap::tileGeneration(int tile)
+{
+    auto it = m_tileGenerations.constFind(tile);
+    if (it != m_tileGenerations.constEnd()) return it.value();
+
+    m_tileGenerations.insert(tile, ++m_generationCounter);
+    return m_generationCounter;
+}
+
+/*
+ * Maps a document change to the tiles it touched. Text that adds or removes
+ * lines shifts every following line, so all later tiles become stale.
+ */
+void Minimap::onDocumentModified(int position, int modificationType, const char *text, int length,
+                                 int linesAdded, int line, int foldLevelNow, int foldLevelPrev,
+                                 int token, int annotationLinesAdded)
+{
+    Q_UNUSED(text);
+    Q_UNUSED(line);
+    Q_UNUSED(foldLevelNow);
+    Q_UNUSED(foldLevelPrev);
+    Q_UNUSED(token);
+    Q_UNUSED(annotationLinesAdded);
+
+    const int contentMask = QsciScintillaBase::SC_MOD_INSERTTEXT | QsciScintillaBase::SC_MOD_DELETETEXT
+                            | QsciScintillaBase::SC_MOD_CHANGESTYLE;
+    if (m_rendering || !(modificationType & contentMask)) return;
+
+    int firstLine = m_editor->SendScintilla(QsciScintillaBase::SCI_LINEFROMPOSITION, static_cast<unsigned long>(position));
+    if (linesAdded != 0) {
+        invalidateLines(firstLine, INT_MAX);
+    } else if (modificationType & QsciScintillaBase::SC_MOD_CHANGESTYLE) {
+        int lastLine = m_editor->SendScintilla(QsciScintillaBase::SCI_LINEFROMPOSITION, static_cast<unsigned long>(position + length));
+        invalidateLines(firstLine, lastLine);
+    } else {
+        invalidateLines(firstLine, firstLine);
+    }
+
+    scheduleUpdate();
+}
+
+void Minimap::invalidateLines(int firstLine, int lastLine)
+{
+    int firstTile = firstLine / TileLines;
+    int lastTile = lastLine == INT_MAX ? INT_MAX : lastLine / TileLines;
+
+    for (auto it = m_tiles.lowerBound(firstTile); it != m_tiles.end() && it.key() <= lastTile; ++it) {
+        invalidateTile(it.key());
+    }
+
+    //* Tiles still waiting for their first render are stale as well *//
+    for (auto it = m_pendingTiles.constBegin(); it != m_pendingTiles.constEnd(); ++it) {
+        if (it.key() >= firstTile && it.key() <= lastTile) {
+            m_tileGenerations.insert(it.key(), ++m_generationCounter);
+        }
+    }
+}
+
+void Minimap::rebuildPalette()
+{
+    m_stylePalette.resize(256);
+    for (int style = 0; style < 256; ++style) {
+        long bgr = m_editor->SendScintilla(QsciScintillaBase::SCI_STYLEGETFORE, static_cast<unsigned long>(style));
+        QColor color(int(bgr & 0xff), int((bgr >> 8) & 0xff), int((bgr >> 16) & 0xff));
+        color.setAlpha(170);
+        m_stylePalette[style] = color;
+    }
+    m_background = m_editor->palette().color(QPalette::Base);
+}
+
+int Minimap::visibleMinimapLines() const
+{
+    return qMax(1, height() / LineHeight);
+}
+
+/*
+ * First document line shown at the top of the minimap. When the document is
+ * taller than the widget, the minimap window scrolls proportionally with the
+ * editor so the visible region always stays inside it.
+ */
+int Minimap::firstMinimapLine() const
+{
+    int totalLines = m_editor->SendScintilla(QsciScintillaBase::SCI_GETLINECOUNT, 0UL, 0L);
+    int minimapLines = visibleMinimapLines();
+    if (totalLines <= minimapLines) return 0;
+
+    int firstVisible = m_editor->SendScintilla(QsciScintillaBase::SCI_GETFIRSTVISIBLELINE, 0UL, 0L);
+    int firstDocLine = m_editor->SendScintilla(QsciScintillaBase::SCI_DOCLINEFROMVISIBLE, static_cast<unsigned long>(firstVisible));
+    int onScreen = m_editor->SendScintilla(QsciScintillaBase::SCI_LINESONSCREEN, 0UL, 0L);
+
+    int scrollable = qMax(1, totalLines - onScreen);
+    qreal ratio = qBound<qreal>(0.0, firstDocLine / qreal(scrollable), 1.0);
+    return int(ratio * (totalLines - minimapLines));
+}
+
 void Minimap::regeneratePixmap()
 {
-    // Use the high-level QsciScintilla API to get text (avoids sptr_t casts)
-    QString fullText = m_editor->text();
-    if (fullText.isEmpty()) {
-        m_pixmap = QPixmap();
-        return;
+    VOLT_TRACE_SCOPE("Minimap::regeneratePixmap");
+    qreal dpr = devicePixelRatioF();
+    if (!qFuzzyCompare(dpr, m_tileDpr)) {
+        invalidateAll();
+        m_tileDpr = dpr;
     }
-    QStringList qlines = fullText.split('\n');
+    if (m_stylePalette.isEmpty()) {
+        rebuildPalette();
+    }
+
+    int totalLines = m_editor->SendScintilla(QsciScintillaBase::SCI_GETLINECOUNT, 0UL, 0L);
+    int first = firstMinimapLine();
+    int firstTile = first / TileLines;
+    int lastTile = qMin(first + visibleMinimapLines(), qMax(0, totalLines - 1)) / TileLines;
 
-    QFont baseFont = m_editor->font();
-    int targetPoint = qMax(4, baseFont.pointSize() / 3);
-    QFont drawFont = baseFont;
-    drawFont.setPointSize(targetPoint);
-    QFontMetrics fm(drawFont);
+    for (int tile = firstTile; tile <= lastTile; ++tile) {
+        if (m_tiles.contains(tile) && !m_dirtyTiles.contains(tile)) continue;
 
-    int linesCount = qlines.count();
-    if (linesCount <= 0) {
-        m_pixmap = QPixmap();
-        return;
+        quint64 generation = tileGeneration(tile);
+        if (m_pendingTiles.value(tile) == generation) continue;
+
+        //* Stale tiles stay on screen until their replacement arrives *//
+        m_pendingTiles.insert(tile, generation);
+        MinimapTileSnapshot snapshot = snapshotTile(tile, generation);
+        m_renderPool.start([this, snapshot]() {
+            emit tileRendered(snapshot.tile, snapshot.generation, rasterizeTile(snapshot));
+        });
     }
 
-    qreal heightPerLine = qreal(height()) / qreal(linesCount);
-    if (heightPerLine < 1.0) heightPerLine = 1.0;
+    //* Drop tiles that scrolled far out of view *//
+    for (auto it = m_tiles.begin(); it != m_tiles.end();) {
+        if (it.key() < firstTile - TileMargin || it.key() > lastTile + TileMargin) {
+            m_dirtyTiles.remove(it.key());
+            m_tileGenerations.remove(it.key());
+            it = m_tiles.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
 
-    int pixH = qMax(1, int(linesCount * heightPerLine));
-    int w = width();
-    QSize pixSize(w, pixH);
-    QPixmap pm(pixSize);
-    pm.fill(Qt::transparent);
+/*
+ * Collects the style runs of one tile. Runs on the GUI thread because it reads
+ * from Scintilla, the result is self-contained so it can be rasterized anywhere.
+ */
+MinimapTileSnapshot Minimap::snapshotTile(int tile, quint64 generation)
+{
+    MinimapTileSnapshot snapshot;
+    snapshot.tile = tile;
+    snapshot.generation = generation;
+    snapshot.width = width();
+    snapshot.devicePixelRatio = m_tileDpr;
+    snapshot.background = m_background;
+    snapshot.palette = m_stylePalette;
 
-    QPainter p(&pm);
-    p.setFont(drawFont);
-    QColor textColor = Qt::lightGray;
-    QColor background = Qt::black;
-    QPalette pal = m_editor->palette();
-    background = pal.color(QPalette::Base);
-    textColor = pal.color(QPalette::Text).lighter(170);
+    int totalLines = m_editor->SendScintilla(QsciScintillaBase::SCI_GETLINECOUNT, 0UL, 0L);
+    int firstLine = tile * TileLines;
+    int endLine = qMin(firstLine + TileLines, totalLines);
+    if (firstLine >= endLine) return snapshot;
 
-    p.fillRect(pm.rect(), background);
+    int maxColumns = width() / CharWidth;
+    int tabWidth = qMax(1, m_editor->tabWidth());
 
-    p.setPen(textColor);
-    for (int i = 0; i < linesCount; ++i) {
-        qreal y = i * heightPerLine;
-        QRectF r(0, y, pm.width(), heightPerLine);
-        QString elided = qlines.at(i);
-        elided = elided.left(200);
-        p.drawText(r, Qt::AlignLeft | Qt::AlignVCenter, elided);
+    //* Lines outside the editor's viewport may not have been lexed yet *//
+    m_rendering = true;
+    if (!m_editor->isLargeFileMode()) {
+        long startPos = m_editor->SendScintilla(QsciScintillaBase::SCI_POSITIONFROMLINE, static_cast<unsigned long>(firstLine));
+        long endPos = m_editor->SendScintilla(QsciScintillaBase::SCI_GETLINEENDPOSITION, static_cast<unsigned long>(endLine - 1));
+        m_editor->SendScintilla(QsciScintillaBase::SCI_COLOURISE, static_cast<unsigned long>(startPos), endPos);
     }
-    p.end();
+    m_rendering = false;
+
+    QByteArray styled;
+
+    for (int line = firstLine; line < endLine; ++line) {
+        long lineStart = m_editor->SendScintilla(QsciScintillaBase::SCI_POSITIONFROMLINE, static_cast<unsigned long>(line));
+        long lineEnd = m_editor->SendScintilla(QsciScintillaBase::SCI_GETLINEENDPOSITION, static_cast<unsigned long>(line));
+        long length = qMin<long>(lineEnd - lineStart, maxColumns);
+        if (length <= 0) continue;
+
+        styled.resize(int(length * 2 + 2));
+        m_editor->SendScintilla(QsciScintillaBase::SCI_GETSTYLEDTEXT, lineStart, lineStart + length, styled.data());
+
+        quint16 row = quint16(line - firstLine);
+        int column = 0;
+        int runStart = 0;
+        int runStyle = -1;
+
+        auto flushRun = [&]() {
+            if (runStyle >= 0 && column > runStart) {
+                snapshot.runs.append({row, quint16(runStart), quint16(column - runStart), quint8(runStyle)});
+            }
+            runStyle = -1;
+        };
+
+        for (long i = 0; i < length && column < maxColumns; ++i) {
+            uchar ch = uchar(styled[int(2 * i)]);
+            int style = uchar(styled[int(2 * i + 1)]);
+
+            if (ch == '\t') {
+                flushRun();
+                column = (column / tabWidth + 1) * tabWidth;
+            } else if (ch == ' ') {
+                flushRun();
+                ++column;
+            } else if ((ch & 0xC0) == 0x80) {
+                // UTF-8 continuation byte, same column as its lead byte
+            } else {
+                if (style != runStyle) {
+                    flushRun();
+                    runStart = column;
+                    runStyle = style;
+                }
+                ++column;
+            }
+        }
+        flushRun();
+    }
+
+    return snapshot;
+}
+
+void Minimap::onTileRendered(int tile, quint64 generation, const QImage &image)
+{
+    if (m_pendingTiles.value(tile) == generation) {
+        m_pendingTiles.remove(tile);
+    }
+
+    //* A newer edit invalidated this tile while it was being rendered *//
+    if (m_tileGenerations.value(tile) != generation) return;
 
-    m_pixmap = pm;
-    m_scale = heightPerLine;
+    m_tiles.insert(tile, QPixmap::fromImage(image));
+    m_dirtyTiles.remove(tile);
+    update(0, (tile * TileLines - firstMinimapLine()) * LineHeight, width(), TileLines * LineHeight);
 }
 
 void Minimap::paintEvent(QPaintEvent *event)
 {
     Q_UNUSED(event);
+    PaintTimer paintTimer(PaintStats::MinimapPaint);
     QPainter p(this);
-    p.fillRect(rect(), palette().color(QPalette::Window));
+    p.fillRect(rect(), m_editor->palette().color(QPalette::Base));
 
-    if (m_pixmap.isNull()) {
-        regeneratePixmap();
-    }
+    int totalLines = m_editor->SendScintilla(QsciScintillaBase::SCI_GETLINECOUNT, 0UL, 0L);
+    if (totalLines <= 0) return;
 
-    if (!m_pixmap.isNull()) {
-        QPixmap scaled = m_pixmap.scaled(width(), height(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-        p.drawPixmap(0, 0, scaled);
+    int first = firstMinimapLine();
+    int firstTile = first / TileLines;
+    int lastTile = qMin(first + visibleMinimapLines(), totalLines - 1) / TileLines;
+    m_lastFirstLine = first;
 
-        QRectF vp = viewportRectOnMinimap();
-        if (!vp.isNull()) {
-            QPen pen(QColor(200, 200, 200, 180));
-            pen.setWidth(1);
-            p.setPen(pen);
-            p.setBrush(QColor(0,0,0,0));
-            p.drawRect(vp);
+    //* Missing tiles are requested from the render thread, the overlay below is painted right away *//
+    for (int tile = firstTile; tile <= lastTile; ++tile) {
+        if (!m_tiles.contains(tile) && !m_pendingTiles.contains(tile)) {
+            scheduleUpdate();
+            break;
         }
-    } else {
-        p.setPen(Qt::gray);
-        p.drawText(rect(), Qt::AlignCenter, "Minimap");
+    }
+
+    //* Tiles are rendered at the widget's scale, so this is a plain blit *//
+    for (int tile = firstTile; tile <= lastTile; ++tile) {
+        auto it = m_tiles.constFind(tile);
+        if (it != m_tiles.constEnd()) {
+            p.drawPixmap(0, (tile * TileLines - first) * LineHeight, it.value());
+        }
+    }
+
+    QRectF vp = viewportRectOnMinimap();
+    m_lastOverlay = vp.toAlignedRect().adjusted(-1, -1, 1, 1);
+    if (!vp.isNull()) {
+        QPen pen(QColor(200, 200, 200, 180));
+        pen.setWidth(1);
+        p.setPen(pen);
+        p.setBrush(QColor(200, 200, 200, 30));
+        p.drawRect(vp);
     }
 }
 
 QRectF Minimap::viewportRectOnMinimap() const
 {
-    int firstLine = m_editor->SendScintilla(QsciScintillaBase::SCI_GETFIRSTVISIBLELINE, 0UL, 0L);
-    int visibleLines = m_editor->SendScintilla(QsciScintillaBase::SCI_LINESONSCREEN, 0UL, 0L);
     int totalLines = m_editor->SendScintilla(QsciScintillaBase::SCI_GETLINECOUNT, 0UL, 0L);
     if (totalLines <= 0) return QRectF();
 
-    qreal y = (firstLine / (qreal)totalLines) * height();
-    qreal h = (visibleLines / (qreal)totalLines) * height();
-    return QRectF(0, y, width(), qMax<qreal>(1.0, h));
+    int firstVisible = m_editor->SendScintilla(QsciScintillaBase::SCI_GETFIRSTVISIBLELINE, 0UL, 0L);
+    int firstDocLine = m_editor->SendScintilla(QsciScintillaBase::SCI_DOCLINEFROMVISIBLE, static_cast<unsigned long>(firstVisible));
+    int visibleLines = m_editor->SendScintilla(QsciScintillaBase::SCI_LINESONSCREEN, 0UL, 0L);
+
+    qreal y = (firstDocLine - firstMinimapLine()) * LineHeight;
+    qreal h = visibleLines * LineHeight;
+    return QRectF(0, y, width() - 1, qMax<qreal>(1.0, h));
 }
 
 void Minimap::resizeEvent(QResizeEvent *event)
 {
-    Q_UNUSED(event);
+    //* Tiles are as wide as the widget, a new width needs new tiles *//
+    if (event->size().width() != event->oldSize().width()) {
+        invalidateAll();
+    }
     scheduleUpdate();
 }
 
+/*
+ * Inverse of viewportRectOnMinimap(): scrolls the editor so the overlay's top
+ * edge lands at y. With a scrolling window the overlay moves slower than the
+ * document, by the ratio of the free minimap space to the scrollable range.
+ */
+void Minimap::scrollToOverlayTop(qreal y)
+{
+    int totalLines = m_editor->SendScintilla(QsciScintillaBase::SCI_GETLINECOUNT, 0UL, 0L);
+    int minimapLines = visibleMinimapLines();
+    int onScreen = m_editor->SendScintilla(QsciScintillaBase::SCI_LINESONSCREEN, 0UL, 0L);
+
+    int targetLine;
+    if (totalLines <= minimapLines) {
+        targetLine = int(y) / LineHeight;
+    } else {
+        int scrollable = qMax(1, totalLines - onScreen);
+        qreal track = qMax<qreal>(1.0, (minimapLines - onScreen) * LineHeight);
+        targetLine = int(qBound<qreal>(0.0, y / track, 1.0) * scrollable);
+    }
+    targetLine = qBound(0, targetLine, qMax(0, totalLines - 1));
+
+    int targetVisible = m_editor->SendScintilla(QsciScintillaBase::SCI_VISIBLEFROMDOCLINE, static_cast<unsigned long>(targetLine));
+    m_editor->SendScintilla(QsciScintillaBase::SCI_SETFIRSTVISIBLELINE, static_cast<unsigned long>(targetVisible));
+}
+
 void Minimap::mousePressEvent(QMouseEvent *event)
 {
-    if (!m_pixmap.isNull()) {
-        qreal ratio = qreal(event->position().y()) / qreal(height());
-        int totalLines = m_editor->SendScintilla(QsciScintillaBase::SCI_GETLINECOUNT, 0UL, 0L);
-        int targetLine = qBound(0, int(ratio * totalLines), totalLines - 1);
+    int totalLines = m_editor->SendScintilla(QsciScintillaBase::SCI_GETLINECOUNT, 0UL, 0L);
+    if (totalLines <= 0) return;
 
-        int visible = m_editor->SendScintilla(QsciScintillaBase::SCI_LINESONSCREEN, 0UL, 0L);
-        int first = qMax(0, targetLine - visible / 2);
-        m_editor->SendScintilla(QsciScintillaBase::SCI_LINESCROLL, 0UL, first);
+    //* Grabbing the overlay drags it like a scrollbar slider *//
+    QRectF vp = viewportRectOnMinimap();
+    if (vp.contains(event->position())) {
+        m_dragOffset = event->position().y() - vp.top();
+        return;
     }
+
+    int targetLine = firstMinimapLine() + int(event->position().y()) / LineHeight;
+    targetLine = qBound(0, targetLine, totalLines - 1);
+
+    int visible = m_editor->SendScintilla(QsciScintillaBase::SCI_LINESONSCREEN, 0UL, 0L);
+    int targetVisible = m_editor->SendScintilla(QsciScintillaBase::SCI_VISIBLEFROMDOCLINE, static_cast<unsigned long>(targetLine));
+    int first = qMax(0, targetVisible - visible / 2);
+    m_editor->SendScintilla(QsciScintillaBase::SCI_SETFIRSTVISIBLELINE, static_cast<unsigned long>(first));
+
+    //* Keep dragging from the overlay's new position *//
+    m_dragOffset = qMax<qreal>(0.0, event->position().y() - viewportRectOnMinimap().top());
 }
 
 void Minimap::mouseMoveEvent(QMouseEvent *event)
 {
-    if (event->buttons() & Qt::LeftButton) {
-        mousePressEvent(event);
+    if ((event->buttons() & Qt::LeftButton) && m_dragOffset >= 0) {
+        scrollToOverlayTop(event->position().y() - m_dragOffset);
     }
 }
+
+void Minimap::mouseReleaseEvent(QMouseEvent *event)
+{
+    Q_UNUSED(event);
+    m_dragOffset = -1;
+}
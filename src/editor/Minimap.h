@@ -4,32 +4,89 @@
 #include <QTimer>
 #include <QPixmap>
 #include <QRectF>
+#include <QMap>
+#include <QSet>
+#include <QVector>
+#include <QColor>
+#include <QHash>
+#include <QImage>
+#include <QThreadPool>
 
 class CodeEditor;
+struct MinimapTileSnapshot;
 
+/*
+ * Overview of the document drawn as colored blocks, one run per style.
+ *
+ * The document is rendered in tiles of TileLines lines at a fixed scale, so
+ * painting is a plain blit of the cached tiles. Edits only invalidate the
+ * tiles whose lines were touched by an SCN_MODIFIED notification.
+ *
+ * Tiles are rasterized on a render thread from snapshots of their style runs.
+ * Each tile carries a generation number, bumped whenever the tile is
+ * invalidated, so renders that finish after a newer edit are discarded.
+ *
+ * Scrolling never touches the tiles. Long documents are shown through a window
+ * that follows the editor, and while that window stays put only the viewport
+ * overlay is repainted.
+ */
 class Minimap : public QWidget
 {
     Q_OBJECT
 public:
     explicit Minimap(CodeEditor *editor, QWidget *parent = nullptr);
+    ~Minimap();
     QSize sizeHint() const override;
 
+    static constexpr int TileLines = 128;
+    static constexpr int LineHeight = 2;
+    static constexpr int CharWidth = 1;
+
+signals:
+    void tileRendered(int tile, quint64 generation, const QImage &image);
+
 protected:
     void paintEvent(QPaintEvent *event) override;
     void resizeEvent(QResizeEvent *event) override;
     void mousePressEvent(QMouseEvent *event) override;
     void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
 
 private slots:
     void scheduleUpdate();
     void doUpdate();
+    void invalidateAll();
+    void onViewportChanged();
+    void onDocumentModified(int position, int modificationType, const char *text, int length,
+                            int linesAdded, int line, int foldLevelNow, int foldLevelPrev,
+                            int token, int annotationLinesAdded);
+    void onTileRendered(int tile, quint64 generation, const QImage &image);
 
 private:
     void regeneratePixmap();
+    MinimapTileSnapshot snapshotTile(int tile, quint64 generation);
+    void invalidateTile(int tile);
+    void invalidateLines(int firstLine, int lastLine);
+    quint64 tileGeneration(int tile);
+    void rebuildPalette();
+    int firstMinimapLine() const;
+    int visibleMinimapLines() const;
     QRectF viewportRectOnMinimap() const;
+    void scrollToOverlayTop(qreal y);
 
     CodeEditor *m_editor;
-    QPixmap m_pixmap;
+    QMap<int, QPixmap> m_tiles;
+    QSet<int> m_dirtyTiles;
+    QHash<int, quint64> m_tileGenerations;
+    QHash<int, quint64> m_pendingTiles;
+    quint64 m_generationCounter;
+    QThreadPool m_renderPool;
+    QVector<QColor> m_stylePalette;
+    QColor m_background;
+    qreal m_tileDpr;
     QTimer m_updateTimer;
-    qreal m_scale;
+    bool m_rendering;
+    int m_lastFirstLine;
+    QRect m_lastOverlay;
+    qreal m_dragOffset;
 };
@@ -0,0 +1,520 @@
+#include "BinaryLog.h"
+
+#include <QDateTime>
+#include <QLocale>
+#include <QVarLengthArray>
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+
+namespace BinaryLog {
+
+namespace {
+
+// One encoded argument; strings point into the encoded buffer instead of being copied
+struct ArgView {
+    quint8 type = 0;
+    quint64 value = 0;
+    const char* text = nullptr;
+};
+
+bool readArg(const uchar*& cursor, const uchar* end, ArgView& arg) {
+    if (cursor >= end) {
+        return false;
+    }
+    arg.type = *cursor++;
+    switch (arg.type) {
+    case ArgInt:
+    case ArgUInt:
+        return readVarint(cursor, end, arg.value);
+    case ArgDouble:
+        if (end - cursor < qint64(sizeof(double))) return false;
+        std::memcpy(&arg.value, cursor, sizeof(double));
+        cursor += sizeof(double);
+        return true;
+    case ArgString:
+        if (!readVarint(cursor, end, arg.value) || quint64(end - cursor) < arg.value) return false;
+        arg.text = reinterpret_cast<const char*>(cursor);
+        cursor += arg.value;
+        return true;
+    case ArgBool:
+        if (cursor >= end) return false;
+        arg.value = *cursor++;
+        return true;
+    default:
+        return false;
+    }
+}
+
+//* ASCII goes in as Latin-1 without a temporary; anything else takes the UTF-8 decoder *//
+void appendUtf8(QString& out, const char* data, qsizetype size) {
+    for (qsizetype i = 0; i < size; ++i) {
+        if (uchar(data[i]) >= 0x80) {
+            out += QString::fromUtf8(data, size);
+            return;
+        }
+    }
+    out += QLatin1String(data, size);
+}
+
+template<typename T>
+void appendNumber(QString& out, T value) {
+    char digits[24];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    out += QLatin1String(digits, qsizetype(result.ptr - digits));
+}
+
+void appendPadding(QString& out, qsizetype count) {
+    for (; count > 0; --count) {
+        out += QLatin1Char(' ');
+    }
+}
+
+void appendArgText(QString& out, const ArgView& arg) {
+    switch (arg.type) {
+    case ArgInt:
+        appendNumber(out, qint64(arg.value >> 1) ^ -qint64(arg.value & 1));
+        break;
+    case ArgUInt:
+        appendNumber(out, arg.value);
+        break;
+    case ArgDouble: {
+        double number;
+        std::memcpy(&number, &arg.value, sizeof(number));
+        out += QString::number(number, 'g', QLocale::FloatingPointShortest);
+        break;
+    }
+    case ArgString:
+        appendUtf8(out, arg.text, qsizetype(arg.value));
+        break;
+    case ArgBool:
+        out += arg.value ? QLatin1String("true") : QLatin1String("false");
+        break;
+    }
+}
+
+// Length of a %1 to %99 placeholder at text, 0 if there is none
+int placeholderAt(const char* text, int& number) {
+    if (text[0] != '%' || text[1] < '0' || text[1] > '9') {
+        return 0;
+    }
+    number = text[1] - '0';
+    if (text[2] >= '0' && text[2] <= '9') {
+        number = number * 10 + (text[2] - '0');
+        return 3;
+    }
+    return 2;
+}
+
+const char* levelText(quint32 level) {
+    switch (level) {
+        case 0: return "TRACE";
+        case 1: return "DEBUG";
+        case 2: return "INFO";
+        case 3: return "WARN";
+        case 4: return "ERROR";
+        case 5: return "FATAL";
+        default: return "UNKNOWN";
+    }
+}
+
+void putDigits(char* at, int value, int width) {
+    for (int i = width - 1; i >= 0; --i) {
+        at[i] = char('0' + value % 10);
+        value /= 10;
+    }
+}
+
+}
+
+void appendVarint(QByteArray& out, quint64 value) {
+    while (value >= 0x80) {
+        out += char((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += char(value);
+}
+
+bool readVarint(const uchar*& cursor, const uchar* end, quint64& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && cursor < end; shift += 7) {
+        uchar byte = *cursor++;
+        value |= quint64(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QStringList decodeArgs(const QByteArray& args) {
+    const uchar* cursor = reinterpret_cast<const uchar*>(args.constData());
+    return decodeArgs(cursor, cursor + args.size(), -1);
+}
+
+QStringList decodeArgs(const uchar* cursor, const uchar* end, int count) {
+    QStringList result;
+    ArgView arg;
+    while (count != 0 && readArg(cursor, end, arg)) {
+        QString text;
+        appendArgText(text, arg);
+        result.append(text);
+        --count;
+    }
+    return result;
+}
+
+QString formatMessage(const QString& format, FormatStyle style, const QStringList& args) {
+    if (style == StyleBrace) {
+        QString result;
+        qsizetype from = 0;
+        for (const QString& arg : args) {
+            qsizetype placeholder = format.indexOf(QLatin1String("{}"), from);
+            if (placeholder < 0) {
+                break;
+            }
+            result += QStringView(format).mid(from, placeholder - from);
+            result += arg;
+            from = placeholder + 2;
+        }
+        result += QStringView(format).mid(from);
+        return result;
+    }
+
+    QString result = format;
+    for (const QString& arg : args) {
+        result = result.arg(arg);
+    }
+    return result;
+}
+
+/*
+ * Writer-side twin of formatMessage: the arguments are read straight from
+ * their encoding and appended to out, so a caller that reuses out formats
+ * without allocating. Percent placeholders are matched the way QString::arg
+ * matches them, the lowest number takes the first argument.
+ */
+void appendMessage(QString& out, const char* format, FormatStyle style, const QByteArray& args) {
+    QVarLengthArray<ArgView, 8> views;
+    const uchar* cursor = reinterpret_cast<const uchar*>(args.constData());
+    const uchar* end = cursor + args.size();
+    ArgView arg;
+    while (readArg(cursor, end, arg)) {
+        views.append(arg);
+    }
+
+    const char* run = format;
+    if (style == StyleBrace) {
+        for (const ArgView& view : views) {
+            const char* placeholder = std::strstr(run, "{}");
+            if (!placeholder) {
+                break;
+            }
+            appendUtf8(out, run, qsizetype(placeholder - run));
+            appendArgText(out, view);
+            run = placeholder + 2;
+        }
+        appendUtf8(out, run, qsizetype(std::strlen(run)));
+        return;
+    }
+
+    QVarLengthArray<int, 8> numbers;
+    int number = 0;
+    for (const char* at = format; *at; ++at) {
+        if (placeholderAt(at, number)) {
+            numbers.append(number);
+        }
+    }
+    std::sort(numbers.begin(), numbers.end());
+    numbers.erase(std::unique(numbers.begin(), numbers.end()), numbers.end());
+
+    for (const char* at = format; *at;) {
+        int length = placeholderAt(at, number);
+        if (!length) {
+            ++at;
+            continue;
+        }
+        qsizetype rank = std::lower_bound(numbers.begin(), numbers.end(), number) - numbers.begin();
+        if (rank < views.size()) {
+            appendUtf8(out, run, qsizetype(at - run));
+            appendArgText(out, views[rank]);
+            run = at + length;
+        }
+        at += length;
+    }
+    appendUtf8(out, run, qsizetype(std::strlen(run)));
+}
+
+QByteArray encodeRecord(qint64 offset, quint32 level, quint32 categoryId, quint32 formatId,
+                        quint64 threadId, int argCount, const QByteArray& args) {
+    QByteArray payload;
+    payload.reserve(16 + args.size());
+    appendVarint(payload, quint64(qMax<qint64>(0, offset)));
+    payload += char(level);
+    appendVarint(payload, categoryId);
+    appendVarint(payload, formatId);
+    appendVarint(payload, threadId);
+    payload += char(qMin(argCount, 255));
+    payload += args;
+    return payload;
+}
+
+bool decodeRecord(const uchar* payload, int size, qint64 baseTimestamp, Record& record) {
+    const uchar* cursor = payload;
+    const uchar* end = payload + size;
+    quint64 offset = 0, categoryId = 0, formatId = 0;
+    if (!readVarint(cursor, end, offset) || cursor >= end) {
+        return false;
+    }
+    record.level = *cursor++;
+    if (!readVarint(cursor, end, categoryId) || !readVarint(cursor, end, formatId)
+        || !readVarint(cursor, end, record.threadId) || cursor >= end) {
+        return false;
+    }
+    int argCount = *cursor++;
+
+    record.timestamp = baseTimestamp + qint64(offset);
+    record.categoryId = quint32(categoryId);
+    record.formatId = quint32(formatId);
+    record.args = decodeArgs(cursor, end, argCount);
+    return true;
+}
+
+QByteArray encodeDefinition(quint32 id, const QString& text, FormatStyle style) {
+    QByteArray payload;
+    appendVarint(payload, id);
+    payload += char(style);
+    payload += text.toUtf8();
+    return payload;
+}
+
+bool decodeDefinition(const uchar* payload, int size, quint32& id, QString& text, FormatStyle& style) {
+    const uchar* cursor = payload;
+    const uchar* end = payload + size;
+    quint64 value = 0;
+    if (!readVarint(cursor, end, value) || cursor >= end) {
+        return false;
+    }
+    id = quint32(value);
+    style = FormatStyle(*cursor++);
+    text = QString::fromUtf8(reinterpret_cast<const char*>(cursor), qsizetype(end - cursor));
+    return true;
+}
+
+//* A frame's size counts the type byte and the payload, the two u16 size fields come on top *//
+static quint16 readSize(const uchar* at) {
+    return quint16(at[0] | (at[1] << 8));
+}
+
+bool readHeader(const uchar* data, qint64 size, SegmentHeader& header) {
+    if (!data || size < qint64(sizeof(SegmentHeader))) {
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    return std::memcmp(header.magic, Magic, sizeof(Magic)) == 0 && header.version == Version
+        && header.headerSize >= sizeof(SegmentHeader);
+}
+
+bool forEachFrame(const uchar* data, qint64 size,
+                  const std::function<void(quint8, const uchar*, int)>& callback) {
+    SegmentHeader header;
+    if (!readHeader(data, size, header)) {
+        return false;
+    }
+
+    qint64 end = qMin<qint64>(size, qint64(header.usedSize));
+    qint64 position = header.headerSize;
+    while (position + 2 <= end) {
+        quint16 frameSize = readSize(data + position);
+        if (frameSize == 0 || position + 4 + frameSize > end) {
+            break;
+        }
+        callback(data[position + 2], data + position + 3, frameSize - 1);
+        position += 4 + frameSize;
+    }
+    return true;
+}
+
+QVector<Record> tailRecords(const uchar* data, quint64 usedSize, int count) {
+    QVector<Record> records;
+    SegmentHeader header;
+    if (!readHeader(data, qint64(usedSize), header)) {
+        return records;
+    }
+
+    //* The trailing size field lets us step back one frame at a time without scanning from the front *//
+    qint64 position = qint64(usedSize);
+    while (records.size() < count && position - 4 >= qint64(header.headerSize)) {
+        quint16 frameSize = readSize(data + position - 2);
+        qint64 start = position - 4 - frameSize;
+        if (frameSize == 0 || start < qint64(header.headerSize) || readSize(data + start) != frameSize) {
+            break;
+        }
+        Record record;
+        if (data[start + 2] == FrameRecord
+            && decodeRecord(data + start + 3, frameSize - 1, header.baseTimestamp, record)) {
+            records.append(std::move(record));
+        }
+        position = start;
+    }
+    std::reverse(records.begin(), records.end());
+    return records;
+}
+
+QString levelName(quint32 level) {
+    return QString::fromLatin1(levelText(level));
+}
+
+void appendLinePrefix(QString& out, qint64 timestamp, quint32 level, QStringView category,
+                      quint64 threadId) {
+    QTime time = QDateTime::fromMSecsSinceEpoch(timestamp).time();
+    char stamp[] = "[hh:mm:ss.zzz] [";
+    putDigits(stamp + 1, time.hour(), 2);
+    putDigits(stamp + 4, time.minute(), 2);
+    putDigits(stamp + 7, time.second(), 2);
+    putDigits(stamp + 10, time.msec(), 3);
+    out += QLatin1String(stamp, qsizetype(sizeof(stamp) - 1));
+
+    const char* name = levelText(level);
+    qsizetype nameLength = qsizetype(std::strlen(name));
+    out += QLatin1String(name, nameLength);
+    appendPadding(out, 5 - nameLength);
+    out += QLatin1String("] [");
+    out += category;
+    appendPadding(out, 8 - category.size());
+    out += QLatin1String("] [Thread:");
+
+    char digits[24];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), threadId);
+    qsizetype digitCount = qsizetype(result.ptr - digits);
+    appendPadding(out, 4 - digitCount);
+    out += QLatin1String(digits, digitCount);
+    out += QLatin1String("] ");
+}
+
+QString formatLine(qint64 timestamp, quint32 level, const QString& category, quint64 threadId,
+                   const QString& message) {
+    QString line;
+    appendLinePrefix(line, timestamp, level, category, threadId);
+    line += message;
+    return line;
+}
+
+void Definitions::clear() {
+    categories.clear();
+    formats.clear();
+    styles.clear();
+}
+
+void Definitions::define(FrameType type, quint32 id, const QString& text, FormatStyle style) {
+    QVector<QString>& table = type == FrameCategory ? categories : formats;
+    if (table.size() <= qsizetype(id)) {
+        table.resize(id + 1);
+    }
+    table[id] = text;
+    if (type == FrameFormat) {
+        styles.resize(formats.size());
+        styles[id] = style;
+    }
+}
+
+QString Definitions::message(const Record& record) const {
+    if (record.formatId == PreformattedFormatId) {
+        return record.args.value(0);
+    }
+    return formatMessage(formats.value(record.formatId), styles.value(record.formatId), record.args);
+}
+
+QString Definitions::line(const Record& record) const {
+    return formatLine(record.timestamp, record.level, categories.value(record.categoryId),
+                      record.threadId, message(record));
+}
+
+SegmentWriter::~SegmentWriter() {
+    close();
+}
+
+bool SegmentWriter::open(const QString& path, qint64 segmentSize) {
+    close();
+    m_path = path;
+    m_segmentSize = segmentSize;
+    return createSegment();
+}
+
+bool SegmentWriter::createSegment() {
+    m_file.setFileName(m_path);
+    if (!m_file.open(QIODevice::ReadWrite | QIODevice::Truncate) || !m_file.resize(m_segmentSize)) {
+        m_file.close();
+        return false;
+    }
+
+    m_data = m_file.map(0, m_segmentSize);
+    if (!m_data) {
+        m_file.close();
+        return false;
+    }
+
+    m_baseTimestamp = QDateTime::currentMSecsSinceEpoch();
+    SegmentHeader header;
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.headerSize = sizeof(SegmentHeader);
+    header.baseTimestamp = m_baseTimestamp;
+    header.usedSize = sizeof(SegmentHeader);
+    std::memcpy(m_data, &header, sizeof(header));
+    m_usedSize.store(sizeof(SegmentHeader), std::memory_order_release);
+    return true;
+}
+
+void SegmentWriter::close() {
+    if (!m_data) {
+        return;
+    }
+
+    //* Trim the unused tail so a finished segment only takes the space it needs *//
+    quint64 used = usedSize();
+    m_file.unmap(m_data);
+    m_data = nullptr;
+    m_file.resize(qint64(used));
+    m_file.close();
+}
+
+/*
+ * The full segment becomes <path>.1, replacing the previous one, and a fresh
+ * segment starts at <path>. At most two segments exist at any time.
+ */
+bool SegmentWriter::rotate() {
+    close();
+    QString previous = m_path + QLatin1String(".1");
+    QFile::remove(previous);
+    QFile::rename(m_path, previous);
+    return createSegment();
+}
+
+bool SegmentWriter::append(FrameType type, const QByteArray& payload) {
+    int frameSize = int(payload.size()) + 1;
+    if (!m_data || frameSize > MaxFramePayload + 1) {
+        return false;
+    }
+
+    quint64 position = usedSize();
+    if (qint64(position) + 4 + frameSize > m_segmentSize) {
+        return false;
+    }
+
+    uchar* out = m_data + position;
+    out[0] = uchar(frameSize & 0xFF);
+    out[1] = uchar(frameSize >> 8);
+    out[2] = type;
+    std::memcpy(out + 3, payload.constData(), size_t(payload.size()));
+    out[2 + frameSize] = uchar(frameSize & 0xFF);
+    out[3 + frameSize] = uchar(frameSize >> 8);
+
+    quint64 used = position + 4 + quint64(frameSize);
+    std::memcpy(m_data + offsetof(SegmentHeader, usedSize), &used, sizeof(used));
+    m_usedSize.store(used, std::memory_order_release);
+    return true;
+}
+
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <QVector>
+#include <atomic>
+#include <functional>
+#include <type_traits>
+
+/*
+ * Compact binary log format.
+ *
+ * A log is a sequence of fixed-size, memory-mapped segments. Each segment
+ * starts with a SegmentHeader and holds frames of the form
+ *
+ *     [u16 size][u8 type][payload][u16 size]
+ *
+ * so a reader can walk forward from the header or backward from usedSize.
+ * Format strings and categories are written once per segment as definition
+ * frames and then referred to by id; a record holds the milliseconds since
+ * the segment base time, the level, the ids, the thread id and the raw
+ * arguments. Every segment is self-contained and decodes on its own.
+ *
+ * Shared between VoltLogger and the volt_logdecode tool, so it depends on
+ * QtCore only.
+ */
+namespace BinaryLog {
+
+enum FrameType : quint8 {
+    FrameFormat = 1,
+    FrameCategory = 2,
+    FrameRecord = 3
+};
+
+enum FormatStyle : quint8 {
+    StylePercent = 0, // Qt-style %1, %2
+    StyleBrace = 1    // {}-style
+};
+
+enum ArgType : quint8 {
+    ArgInt = 1,
+    ArgUInt = 2,
+    ArgDouble = 3,
+    ArgString = 4,
+    ArgBool = 5
+};
+
+//* Format id 0 is reserved for preformatted messages, the record's only argument is the text *//
+constexpr quint32 PreformattedFormatId = 0;
+constexpr int MaxFramePayload = 0xFFFF - 1;
+
+struct SegmentHeader {
+    char magic[8];
+    quint32 version;
+    quint32 headerSize;
+    qint64 baseTimestamp;
+    quint64 usedSize;
+};
+
+constexpr char Magic[8] = {'V', 'O', 'L', 'T', 'L', 'O', 'G', '1'};
+constexpr quint32 Version = 1;
+
+// Variable-length integer encoding
+void appendVarint(QByteArray& out, quint64 value);
+bool readVarint(const uchar*& cursor, const uchar* end, quint64& value);
+
+// Argument encoding, used on the logging thread
+inline void appendArg(QByteArray& out, bool value) {
+    out += char(ArgBool);
+    out += char(value ? 1 : 0);
+}
+
+inline void appendStringArg(QByteArray& out, const QByteArray& utf8) {
+    out += char(ArgString);
+    appendVarint(out, quint64(utf8.size()));
+    out += utf8;
+}
+
+inline void appendArg(QByteArray& out, const QString& value) { appendStringArg(out, value.toUtf8()); }
+inline void appendArg(QByteArray& out, QStringView value) { appendStringArg(out, value.toUtf8()); }
+inline void appendArg(QByteArray& out, const char* value) { appendStringArg(out, QByteArray(value)); }
+inline void appendArg(QByteArray& out, const QByteArray& value) { appendStringArg(out, value); }
+inline void appendArg(QByteArray& out, QChar value) { appendStringArg(out, QString(value).toUtf8()); }
+
+template<typename T>
+std::enable_if_t<std::is_integral_v<T> && std::is_signed_v<T>> appendArg(QByteArray& out, T value) {
+    out += char(ArgInt);
+    qint64 wide = value;
+    appendVarint(out, (quint64(wide) << 1) ^ quint64(wide >> 63));
+}
+
+template<typename T>
+std::enable_if_t<std::is_integral_v<T> && std::is_unsigned_v<T> && !std::is_same_v<T, bool>> appendArg(QByteArray& out, T value) {
+    out += char(ArgUInt);
+    appendVarint(out, quint64(value));
+}
+
+template<typename T>
+std::enable_if_t<std::is_floating_point_v<T>> appendArg(QByteArray& out, T value) {
+    out += char(ArgDouble);
+    double wide = value;
+    out.append(reinterpret_cast<const char*>(&wide), sizeof(wide));
+}
+
+template<typename T>
+std::enable_if_t<std::is_enum_v<T>> appendArg(QByteArray& out, T value) {
+    appendArg(out, std::underlying_type_t<T>(value));
+}
+
+// Turns encoded arguments back into their text form
+QStringList decodeArgs(const QByteArray& args);
+QStringList decodeArgs(const uchar* cursor, const uchar* end, int count);
+
+// Applies decoded arguments to a format string of the given style
+QString formatMessage(const QString& format, FormatStyle style, const QStringList& args);
+
+// Same output as formatMessage, appended to out straight from the encoded arguments
+void appendMessage(QString& out, const char* format, FormatStyle style, const QByteArray& args);
+
+struct Record {
+    qint64 timestamp = 0;
+    quint32 level = 0;
+    quint32 categoryId = 0;
+    quint32 formatId = 0;
+    quint64 threadId = 0;
+    QStringList args;
+};
+
+// Builds the payload of a record frame
+QByteArray encodeRecord(qint64 offset, quint32 level, quint32 categoryId, quint32 formatId,
+                        quint64 threadId, int argCount, const QByteArray& args);
+bool decodeRecord(const uchar* payload, int size, qint64 baseTimestamp, Record& record);
+
+// Definition frames: id followed by the UTF-8 text (and the style for formats)
+QByteArray encodeDefinition(quint32 id, const QString& text, FormatStyle style = StylePercent);
+bool decodeDefinition(const uchar* payload, int size, quint32& id, QString& text, FormatStyle& style);
+
+// Copies the header out and checks magic and version
+bool readHeader(const uchar* data, qint64 size, SegmentHeader& header);
+
+// Walks the frames of a segment front to back; the callback gets type, payload and size
+bool forEachFrame(const uchar* data, qint64 size,
+                  const std::function<void(quint8, const uchar*, int)>& callback);
+
+// The last count records of a segment, oldest first, found by walking backward from usedSize
+QVector<Record> tailRecords(const uchar* data, quint64 usedSize, int count);
+
+// Same line layout as the text log
+QString levelName(quint32 level);
+void appendLinePrefix(QString& out, qint64 timestamp, quint32 level, QStringView category,
+                      quint64 threadId);
+QString formatLine(qint64 timestamp, quint32 level, const QString& category, quint64 threadId,
+                   const QString& message);
+
+/*
+ * Format strings and categories seen so far in one segment, indexed by id.
+ * Id 0 is never defined: format 0 is PreformattedFormatId and category ids
+ * start at 1.
+ */
+struct Definitions {
+    QVector<QString> categories;
+    QVector<QString> formats;
+    QVector<FormatStyle> styles;
+
+    void clear();
+    void define(FrameType type, quint32 id, const QString& text, FormatStyle style);
+    QString message(const Record& record) const;
+    QString line(const Record& record) const;
+};
+
+/*
+ * Writes frames into a memory-mapped segment file. When a frame does not fit,
+ * append() returns false; the caller rotates, re-emits its definitions and
+ * retries. usedSize() may be read from other threads, bytes below it never
+ * change until the next rotation.
+ */
+class SegmentWriter {
+public:
+    ~SegmentWriter();
+
+    bool open(const QString& path, qint64 segmentSize);
+    void close();
+    bool rotate();
+    bool isOpen() const { return m_data != nullptr; }
+
+    bool append(FrameType type, const QByteArray& payload);
+
+    const uchar* data() const { return m_data; }
+    quint64 usedSize() const { return m_usedSize.load(std::memory_order_acquire); }
+    qint64 baseTimestamp() const { return m_baseTimestamp; }
+
+private:
+    bool createSegment();
+
+    QString m_path;
+    qint64 m_segmentSize = 0;
+    QFile m_file;
+    uchar* m_data = nullptr;
+    qint64 m_baseTimestamp = 0;
+    std::atomic<quint64> m_usedSize{0};
+};
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/*
+ * Bounded multi-producer, single-consumer queue (Dmitry Vyukov's design).
+ *
+ * A producer claims a slot with one compare-and-swap on the enqueue counter
+ * and publishes it through the slot's sequence number, so pushing never
+ * takes a lock and never allocates. Only one thread may pop.
+ *
+ * Capacity must be a power of two.
+ */
+template<typename T>
+class LogRing {
+public:
+    explicit LogRing(size_t capacity)
+        : m_mask(capacity - 1), m_slots(new Slot[capacity]) {
+        for (size_t i = 0; i < capacity; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    LogRing(const LogRing&) = delete;
+    LogRing& operator=(const LogRing&) = delete;
+
+    // Moves value into the queue, leaves it untouched and returns false when full
+    bool tryPush(T& value) {
+        size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &m_slots[position & m_mask];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            intptr_t difference = intptr_t(sequence) - intptr_t(position);
+            if (difference == 0) {
+                if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = m_enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->value = std::move(value);
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side only
+    bool tryPop(T& value) {
+        Slot& slot = m_slots[m_dequeuePosition & m_mask];
+        if (slot.sequence.load(std::memory_order_acquire) != m_dequeuePosition + 1) {
+            return false;
+        }
+
+        value = std::move(slot.value);
+        slot.value = T();
+        slot.sequence.store(m_dequeuePosition + m_mask + 1, std::memory_order_release);
+        ++m_dequeuePosition;
+        return true;
+    }
+
+    // Consumer side only, true when tryPop would succeed
+    bool canPop() const {
+        return m_slots[m_dequeuePosition & m_mask].sequence.load(std::memory_order_acquire) == m_dequeuePosition + 1;
+    }
+
+    size_t capacity() const { return m_mask + 1; }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    const size_t m_mask;
+    std::unique_ptr<Slot[]> m_slots;
+
+    //* Producers and the consumer touch different counters, keep them on different cache lines *//
+    alignas(64) std::atomic<size_t> m_enqueuePosition{0};
+    alignas(64) size_t m_dequeuePosition = 0;
+};
@@ -0,0 +1,45 @@
+#include "PaintStats.h"
+
+namespace {
+
+// Upper bounds of all but the last bucket
+constexpr std::array<qint64, PaintStats::BucketCount - 1> BucketLimitsUs = {1000, 2000, 4000, 8000, 16000, 33000};
+
+}
+
+PaintStats& PaintStats::instance() {
+    static PaintStats instance;
+    return instance;
+}
+
+void PaintStats::record(Source source, qint64 durationUs) {
+    Histogram& histogram = m_histograms[source];
+    int bucket = 0;
+    while (bucket < int(BucketLimitsUs.size()) && durationUs >= BucketLimitsUs[bucket]) {
+        ++bucket;
+    }
+    ++histogram.buckets[bucket];
+    ++histogram.count;
+    histogram.totalUs += durationUs;
+    histogram.maxUs = qMax(histogram.maxUs, durationUs);
+}
+
+void PaintStats::reset() {
+    m_histograms = {};
+}
+
+QString PaintStats::sourceName(Source source) {
+    switch (source) {
+        case CodeEditorPaint: return "CodeEditor";
+        case MinimapPaint:    return "Minimap";
+        case TreeViewPaint:   return "CustomTreeView";
+        default:              return "Unknown";
+    }
+}
+
+QString PaintStats::bucketLabel(int bucket) {
+    if (bucket >= int(BucketLimitsUs.size())) {
+        return QString(">= %1 ms").arg(BucketLimitsUs.back() / 1000);
+    }
+    return QString("< %1 ms").arg(BucketLimitsUs[bucket] / 1000);
+}
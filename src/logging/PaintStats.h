@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QString>
+#include <array>
+
+/*
+ * Paint-time histograms for the widgets that repaint most often.
+ *
+ * Recording and reading both happen on the GUI thread, so the counters are
+ * plain integers. Buckets are powers of two in milliseconds up to two frames
+ * at 60 Hz; the last one takes everything slower.
+ */
+class PaintStats {
+public:
+    enum Source {
+        CodeEditorPaint,
+        MinimapPaint,
+        TreeViewPaint,
+        SourceCount
+    };
+
+    static constexpr int BucketCount = 7;
+
+    struct Histogram {
+        std::array<quint64, BucketCount> buckets{};
+        quint64 count = 0;
+        qint64 totalUs = 0;
+        qint64 maxUs = 0;
+    };
+
+    static PaintStats& instance();
+
+    void record(Source source, qint64 durationUs);
+    const Histogram& histogram(Source source) const { return m_histograms[source]; }
+    void reset();
+
+    static QString sourceName(Source source);
+    static QString bucketLabel(int bucket);
+
+private:
+    PaintStats() = default;
+
+    std::array<Histogram, SourceCount> m_histograms{};
+};
+
+// Times one paint event into the source's histogram
+class PaintTimer {
+public:
+    explicit PaintTimer(PaintStats::Source source) : m_source(source) { m_timer.start(); }
+    ~PaintTimer() { PaintStats::instance().record(m_source, m_timer.nsecsElapsed() / 1000); }
+
+    PaintTimer(const PaintTimer&) = delete;
+    PaintTimer& operator=(const PaintTimer&) = delete;
+
+private:
+    PaintStats::Source m_source;
+    QElapsedTimer m_timer;
+};
@@ -0,0 +1,100 @@
+#include "UiWatchdog.h"
+#include "VoltLogger.h"
+#include "VoltTrace.h"
+#include <QTimer>
+#include <chrono>
+
+UiWatchdog& UiWatchdog::instance() {
+    static UiWatchdog instance;
+    return instance;
+}
+
+UiWatchdog::~UiWatchdog() {
+    stop();
+}
+
+qint64 UiWatchdog::nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void UiWatchdog::start(int thresholdMs) {
+    if (m_running.load()) {
+        return;
+    }
+
+    m_thresholdMs = qMax(thresholdMs, HeartbeatMs * 2);
+    m_lastBeatMs.store(nowMs(), std::memory_order_relaxed);
+    VoltTrace::instance().setScopeTracking(true);
+
+    if (!m_timer) {
+        m_timer = new QTimer(this);
+        m_timer->setTimerType(Qt::PreciseTimer);
+        connect(m_timer, &QTimer::timeout, this, &UiWatchdog::beat);
+    }
+    m_timer->start(HeartbeatMs);
+
+    m_running.store(true);
+    m_monitor = std::thread([this]() { monitorLoop(); });
+}
+
+void UiWatchdog::stop() {
+    if (!m_running.exchange(false)) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_stopMutex);
+    }
+    m_stopped.notify_all();
+    if (m_monitor.joinable()) {
+        m_monitor.join();
+    }
+    if (m_timer) {
+        m_timer->stop();
+    }
+    VoltTrace::instance().setScopeTracking(false);
+}
+
+/*
+ * GUI thread. A late heartbeat means the loop was blocked in between, so the
+ * stall is reported here with its full length.
+ */
+void UiWatchdog::beat() {
+    qint64 now = nowMs();
+    qint64 last = m_lastBeatMs.exchange(now, std::memory_order_relaxed);
+    qint64 stalledMs = now - last - HeartbeatMs;
+    if (stalledMs < m_thresholdMs) {
+        return;
+    }
+
+    VOLT_PERF_F("UI thread was blocked for %1 ms", stalledMs);
+    VoltTrace& trace = VoltTrace::instance();
+    if (trace.isEnabled()) {
+        qint64 endUs = trace.nowUs();
+        trace.addComplete("UI stall", "perf", endUs - stalledMs * 1000, endUs);
+    }
+}
+
+/*
+ * Monitor thread. Reports a stall while it is still happening, naming the
+ * span the GUI thread is in, once per stall.
+ */
+void UiWatchdog::monitorLoop() {
+    qint64 reportedBeat = -1;
+    std::unique_lock<std::mutex> lock(m_stopMutex);
+    while (m_running.load()) {
+        m_stopped.wait_for(lock, std::chrono::milliseconds(HeartbeatMs));
+
+        qint64 lastBeat = m_lastBeatMs.load(std::memory_order_relaxed);
+        qint64 blockedMs = nowMs() - lastBeat;
+        if (blockedMs < m_thresholdMs || lastBeat == reportedBeat) {
+            continue;
+        }
+
+        reportedBeat = lastBeat;
+        m_stallCount.fetch_add(1, std::memory_order_relaxed);
+        const char* span = VoltTrace::instance().mainThreadSpan();
+        VOLT_PERF_F("UI thread blocked for %1 ms, inside %2", blockedMs, span ? span : "no traced scope");
+    }
+}
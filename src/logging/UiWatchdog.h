@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QObject>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+class QTimer;
+
+/*
+ * Detects a blocked GUI event loop.
+ *
+ * A timer on the GUI thread stamps a heartbeat; a monitor thread checks the
+ * stamp and, once it is older than the threshold, logs a PERF warning naming
+ * the main thread's innermost VoltTrace span. When the loop comes back the
+ * GUI thread logs how long the stall lasted and, while tracing, adds it to
+ * the trace.
+ */
+class UiWatchdog : public QObject {
+    Q_OBJECT
+public:
+    static UiWatchdog& instance();
+
+    // Call on the GUI thread
+    void start(int thresholdMs = DefaultThresholdMs);
+    void stop();
+    bool isRunning() const { return m_running.load(std::memory_order_relaxed); }
+
+    quint64 stallCount() const { return m_stallCount.load(std::memory_order_relaxed); }
+
+    static constexpr int DefaultThresholdMs = 250;
+    static constexpr int HeartbeatMs = 50;
+
+private:
+    UiWatchdog() = default;
+    ~UiWatchdog();
+
+    void beat();
+    void monitorLoop();
+    static qint64 nowMs();
+
+    QTimer* m_timer = nullptr;
+    int m_thresholdMs = DefaultThresholdMs;
+    std::atomic<qint64> m_lastBeatMs{0};
+    std::atomic<bool> m_running{false};
+    std::atomic<quint64> m_stallCount{0};
+
+    std::thread m_monitor;
+    std::mutex m_stopMutex;
+    std::condition_variable m_stopped;
+};
@@ -2,8 +2,60 @@
 #include <QDir>
 #include <QCoreApplication>
 #include <QThread>
+#include <chrono>
 #include <iostream>
 
+namespace {
+
+// Last count lines of text; dropFirst discards a partial line cut off by the read
+QStringList lastLines(QByteArray text, int count, bool dropFirst) {
+    text.replace("\r\n", "\n");
+    QStringList lines = QString::fromUtf8(text).split('\n');
+    if (!lines.isEmpty() && lines.last().isEmpty()) {
+        lines.removeLast();
+    }
+    if (dropFirst && !lines.isEmpty()) {
+        lines.removeFirst();
+    }
+    return lines.mid(qMax<qsizetype>(0, lines.size() - count));
+}
+
+/*
+ * Reads a text log backward in fixed-size chunks until it has count lines,
+ * so the cost depends on the lines asked for, not on the file size.
+ */
+QStringList readTailLines(const QString& path, int count) {
+    QFile file(path);
+    if (count <= 0 || !file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    
+    constexpr qint64 ChunkSize = 64 * 1024;
+    qint64 position = file.size();
+    QByteArray tail;
+    qsizetype newlines = 0;
+    //? One newline more than lines asked for, the file ends with one
+    while (position > 0 && newlines <= count) {
+        qint64 chunkSize = qMin(ChunkSize, position);
+        position -= chunkSize;
+        file.seek(position);
+        QByteArray chunk = file.read(chunkSize);
+        newlines += chunk.count('\n');
+        tail.prepend(chunk);
+    }
+    return lastLines(tail, count, position > 0);
+}
+
+QStringList readCompressedTail(const QString& path, int count) {
+    QFile file(path);
+    if (count <= 0 || !file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    return lastLines(qUncompress(file.readAll()), count, false);
+}
+
+}
+
 VoltLogger& VoltLogger::instance() {
     static VoltLogger instance;
     return instance;
@@ -21,9 +73,9 @@ void VoltLogger::initialize(const QString& logFilePath, LogLevel minLevel, bool
     }
     
     m_logFilePath = logFilePath;
-    m_minLevel = minLevel;
-    m_consoleEnabled = enableConsole;
-    m_fileEnabled = true;
+    m_minLevel.store(minLevel);
+    m_consoleEnabled.store(enableConsole);
+    m_fileEnabled.store(true);
     
     // Create logs directory if it doesn't exist
     QFileInfo fileInfo(logFilePath);
@@ -32,30 +84,45 @@ void VoltLogger::initialize(const QString& logFilePath, LogLevel minLevel, bool
         logDir.mkpath(".");
     }
     
-    // Initialize log file
-    m_logFile = std::make_unique<QFile>(logFilePath);
-    
-    QIODevice::OpenMode openMode = QIODevice::WriteOnly | QIODevice::Text;
-    if (!clearOnStart) {
-        openMode |= QIODevice::Append;
+    bool opened = false;
+    if (m_binaryLog) {
+        // Segments are rewritten from the start, keep the previous session as <name>.vlog.1
+        m_logFilePath = logDir.filePath(fileInfo.completeBaseName() + ".vlog");
+        if (!clearOnStart && QFile::exists(m_logFilePath)) {
+            QFile::remove(m_logFilePath + ".1");
+            QFile::rename(m_logFilePath, m_logFilePath + ".1");
+        }
+        opened = m_segment.open(m_logFilePath, BinarySegmentSize);
+    } else {
+        // Initialize log file
+        m_logFile = std::make_unique<QFile>(logFilePath);
+        
+        QIODevice::OpenMode openMode = QIODevice::WriteOnly | QIODevice::Text;
+        if (!clearOnStart) {
+            openMode |= QIODevice::Append;
+        }
+        opened = m_logFile->open(openMode);
+        m_logFileSize = m_logFile->size();
+        m_logFileOpened = QDateTime::currentMSecsSinceEpoch();
     }
     
-    if (m_logFile->open(openMode)) {
-        m_logStream = std::make_unique<QTextStream>(m_logFile.get());
-        m_initialized = true;
-        
-        // Start session
+    if (opened) {
+        // Start session before the writer owns the file
         startSession();
+
+        m_stopWriter.store(false);
+        m_writer = std::thread([this]() { writerLoop(); });
+        m_initialized.store(true, std::memory_order_release);
         
         if (m_consoleEnabled) {
             std::cout << "✅ VoltLogger initialized successfully" << std::endl;
-            std::cout << "📁 Log file: " << logFilePath.toStdString() << std::endl;
+            std::cout << "📁 Log file: " << m_logFilePath.toStdString() << std::endl;
             std::cout << "📊 Log level: " << levelToString(minLevel).toStdString() << std::endl;
         }
     } else {
         if (m_consoleEnabled) {
             std::cerr << "❌ Failed to initialize VoltLogger - cannot open log file: " 
-                     << logFilePath.toStdString() << std::endl;
+                     << m_logFilePath.toStdString() << std::endl;
         }
     }
 }
@@ -77,10 +144,8 @@ void VoltLogger::startSession() {
      .arg(QDir::currentPath())
      .arg(QString::number(reinterpret_cast<qintptr>(QThread::currentThreadId())));
     
-    if (m_logStream) {
-        *m_logStream << sessionHeader << "\n";
-        m_logStream->flush();
-    }
+    //? Written directly, only called while the writer thread is not running
+    writeSessionText(sessionHeader);
     
     if (m_consoleEnabled) {
         std::cout << sessionHeader.toStdString() << std::endl;
@@ -88,7 +153,7 @@ void VoltLogger::startSession() {
 }
 
 void VoltLogger::endSession() {
-    if (!m_initialized) return;
+    if (!m_logFile && !m_segment.isOpen()) return;
     
     QDateTime sessionEnd = QDateTime::currentDateTime();
     qint64 duration = m_sessionStart.msecsTo(sessionEnd);
@@ -105,10 +170,8 @@ void VoltLogger::endSession() {
      .arg(duration / 1000.0, 0, 'f', 2)
      .arg(m_logCount);
     
-    if (m_logStream) {
-        *m_logStream << sessionFooter << "\n";
-        m_logStream->flush();
-    }
+    //? Written directly, only called after the writer thread has stopped
+    writeSessionText(sessionFooter);
     
     if (m_consoleEnabled) {
         std::cout << sessionFooter.toStdString() << std::endl;
@@ -116,50 +179,386 @@ void VoltLogger::endSession() {
 }
 
 void VoltLogger::log(LogLevel level, const QString& message, const QString& category) {
-    if (!m_initialized || level < m_minLevel) {
+    if (!m_initialized.load(std::memory_order_acquire) || level < m_minLevel.load(std::memory_order_relaxed)) {
         return;
     }
     
-    QMutexLocker locker(&m_mutex);
+    LogRecord record;
+    record.message = message;
+    submit(level, category, record);
+}
+
+void VoltLogger::submit(LogLevel level, const QString& category, LogRecord& record) {
+    record.timestamp = QDateTime::currentMSecsSinceEpoch();
+    record.threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+    record.level = level;
+    record.category = category;
+    enqueue(record);
     
-    QString formattedEntry = formatLogEntry(level, message, category);
-    m_logCount++;
+    // Errors are written out right away instead of waiting for the flush timer
+    if (level >= ERROR) {
+        wakeWriter();
+    }
+    if (level == FATAL) {
+        flush();
+    }
+}
+
+void VoltLogger::enqueue(LogRecord& record) {
+    if (m_queue.tryPush(record)) {
+        return;
+    }
     
-    // Write to file
-    if (m_fileEnabled && m_logStream) {
-        *m_logStream << formattedEntry << "\n";
-        m_logStream->flush(); // Ensure immediate write
+    //* Errors are never dropped, whatever the policy *//
+    if (m_overflowPolicy.load(std::memory_order_relaxed) == Block || record.level >= ERROR) {
+        while (!m_queue.tryPush(record)) {
+            wakeWriter();
+            std::this_thread::yield();
+        }
+        return;
     }
     
-    // Write to console
-    if (m_consoleEnabled) {
-        std::cout << formattedEntry.toStdString() << std::endl;
+    m_dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+/*
+ * Writer thread: drains the ring in batches, formats on this thread so
+ * producers never pay for timestamps or padding, and flushes the file on
+ * the timer, after errors, for flush() callers and on shutdown.
+ */
+void VoltLogger::writerLoop() {
+    using Clock = std::chrono::steady_clock;
+    const auto flushInterval = std::chrono::milliseconds(FlushIntervalMs);
+    
+    QByteArray batch;
+    auto lastFlush = Clock::now();
+    bool dirty = false;
+    
+    for (;;) {
+        bool stopping = m_stopWriter.load(std::memory_order_acquire);
+        quint64 flushTarget = m_flushRequested.load(std::memory_order_acquire);
+        bool urgent = false;
+        bool drained = false;
+        int batched = 0;
+        
+        LogRecord record;
+        while (m_queue.tryPop(record)) {
+            writeRecord(record, batch);
+            urgent = urgent || record.level >= ERROR;
+            drained = true;
+            ++m_logCount;
+            
+            if (++batched >= MaxBatchRecords) {
+                writeOut(batch);
+                batch.resize(0);
+                batched = 0;
+                dirty = true;
+            }
+        }
+        
+        quint64 dropped = m_dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            LogRecord notice;
+            notice.timestamp = QDateTime::currentMSecsSinceEpoch();
+            notice.threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+            notice.level = WARN;
+            notice.category = "LOGGER";
+            notice.message = QString("%1 log records dropped").arg(dropped);
+            writeRecord(notice, batch);
+        }
+        
+        if (!batch.isEmpty()) {
+            writeOut(batch);
+            batch.resize(0);
+            dirty = true;
+        }
+        rotateIfNeeded();
+        
+        bool flushWanted = flushTarget != m_flushCompleted;
+        auto now = Clock::now();
+        if (dirty && (urgent || flushWanted || stopping || now - lastFlush >= flushInterval)) {
+            if (m_logFile) {
+                m_logFile->flush();
+            }
+            std::cout.flush();
+            lastFlush = now;
+            dirty = false;
+        }
+        
+        if (flushWanted) {
+            {
+                std::lock_guard<std::mutex> lock(m_flushMutex);
+                m_flushCompleted = flushTarget;
+            }
+            m_flushed.notify_all();
+        }
+        
+        if (stopping) {
+            return;
+        }
+        if (!drained && dropped == 0) {
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_wakeup.wait_for(lock, flushInterval, [this]() {
+                return m_stopWriter.load(std::memory_order_acquire)
+                    || m_flushRequested.load(std::memory_order_acquire) != m_flushCompleted
+                    || m_queue.canPop();
+            });
+        }
     }
 }
 
-QString VoltLogger::formatLogEntry(LogLevel level, const QString& message, const QString& category) {
-    QString timestamp = QDateTime::currentDateTime().toString("hh:mm:ss.zzz");
-    QString levelStr = levelToString(level);
-    QString threadId = QString::number(reinterpret_cast<qintptr>(QThread::currentThreadId()));
+/*
+ * Taking m_wakeMutex orders the notify after the writer's predicate check:
+ * either the writer sees the new state before it waits, or it is already
+ * waiting when the notify arrives.
+ */
+void VoltLogger::wakeWriter() {
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+    }
+    m_wakeup.notify_one();
+}
+
+/*
+ * Routes one record: binary mode appends a frame to the segment and only
+ * formats text when the console wants it, text mode always formats.
+ * Lines are built in m_lineBuffer and encoded straight into the batch; both
+ * keep their capacity, so a steady stream of records formats without
+ * allocating.
+ */
+void VoltLogger::writeRecord(const LogRecord& record, QByteArray& batch) {
+    if (m_binaryLog) {
+        if (m_fileEnabled.load(std::memory_order_relaxed)) {
+            writeBinary(record);
+        }
+        if (!m_consoleEnabled.load(std::memory_order_relaxed)) {
+            return;
+        }
+    }
+    m_lineBuffer.resize(0);
+    BinaryLog::appendLinePrefix(m_lineBuffer, record.timestamp, record.level, record.category,
+                                record.threadId);
+    if (record.format) {
+        BinaryLog::appendMessage(m_lineBuffer, record.format, record.style, record.args);
+    } else {
+        m_lineBuffer += record.message;
+    }
+    
+    qsizetype used = batch.size();
+    batch.resize(used + m_lineEncoder.requiredSpace(m_lineBuffer.size()) + 1);
+    char* tail = m_lineEncoder.appendToBuffer(batch.data() + used, m_lineBuffer);
+    *tail++ = '\n';
+    batch.resize(qsizetype(tail - batch.constData()));
     
-    return QString("[%1] [%2] [%3] [Thread:%4] %5")
-        .arg(timestamp)
-        .arg(levelStr.leftJustified(5))
-        .arg(category.leftJustified(8))
-        .arg(threadId.rightJustified(4))
-        .arg(message);
+    // Text mode keeps the newest lines in memory for getRecentLogs()
+    if (!m_binaryLog) {
+        std::lock_guard<std::mutex> lock(m_recentMutex);
+        if (m_recentLines.size() < RecentLinesCapacity) {
+            m_recentLines.append(QString(m_lineBuffer.constData(), m_lineBuffer.size()));
+        } else {
+            //? Copied into the slot's own buffer, sharing m_lineBuffer would make the next record detach it
+            QString& slot = m_recentLines[m_recentHead];
+            slot.resize(0);
+            slot.append(m_lineBuffer.constData(), m_lineBuffer.size());
+            m_recentHead = (m_recentHead + 1) % RecentLinesCapacity;
+        }
+    }
 }
 
-QString VoltLogger::levelToString(LogLevel level) {
-    switch (level) {
-        case TRACE: return "TRACE";
-        case DEBUG: return "DEBUG";
-        case INFO:  return "INFO";
-        case WARN:  return "WARN";
-        case ERROR: return "ERROR";
-        case FATAL: return "FATAL";
-        default:    return "UNKNOWN";
+QString VoltLogger::rotatedLogPath(int index) const {
+    return QString("%1.%2.z").arg(m_logFilePath).arg(index);
+}
+
+/*
+ * Starts a new text log once the current one is too large or too old. The
+ * old file is renamed under m_rotateMutex and the new one opened right away;
+ * compressing it into <path>.1.z happens afterwards, while records keep
+ * queuing. Only MaxRotatedLogs compressed files are kept.
+ */
+void VoltLogger::rotateIfNeeded() {
+    if (!m_logFile) {
+        return;
+    }
+    bool tooLarge = m_logFileSize >= MaxLogFileSize;
+    bool tooOld = m_logFileSize > 0 && QDateTime::currentMSecsSinceEpoch() - m_logFileOpened >= MaxLogFileAgeMs;
+    if (!tooLarge && !tooOld) {
+        return;
     }
+    
+    QString pending = m_logFilePath + ".1";
+    {
+        std::lock_guard<std::mutex> lock(m_rotateMutex);
+        m_logFile->close();
+        QFile::remove(rotatedLogPath(MaxRotatedLogs));
+        for (int index = MaxRotatedLogs - 1; index >= 1; --index) {
+            QFile::rename(rotatedLogPath(index), rotatedLogPath(index + 1));
+        }
+        QFile::remove(pending);
+        QFile::rename(m_logFilePath, pending);
+        
+        m_logFile->open(QIODevice::WriteOnly | QIODevice::Text);
+        m_logFileSize = 0;
+        m_logFileOpened = QDateTime::currentMSecsSinceEpoch();
+    }
+    
+    QFile source(pending);
+    if (!source.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    QByteArray compressed = qCompress(source.readAll());
+    source.close();
+    
+    std::lock_guard<std::mutex> lock(m_rotateMutex);
+    QFile target(rotatedLogPath(1));
+    if (target.open(QIODevice::WriteOnly) && target.write(compressed) == compressed.size()) {
+        target.close();
+        QFile::remove(pending);
+    }
+}
+
+/*
+ * A record that no frame can hold would fail in every segment, and rotating
+ * for it would throw away the previous segment for nothing. It is written
+ * as preformatted text cut to the frame size instead.
+ */
+bool VoltLogger::fitsInFrame(const LogRecord& record) {
+    if (record.format) {
+        return int(qstrlen(record.format)) + FrameReserve <= BinaryLog::MaxFramePayload
+            && record.args.size() + FrameReserve <= BinaryLog::MaxFramePayload;
+    }
+    //? Cheap bound first: UTF-8 needs at most three bytes per UTF-16 unit
+    return record.message.size() * 3 + FrameReserve <= BinaryLog::MaxFramePayload
+        || record.message.toUtf8().size() + FrameReserve <= BinaryLog::MaxFramePayload;
+}
+
+VoltLogger::LogRecord VoltLogger::truncatedRecord(const LogRecord& record) {
+    static const QString marker = QStringLiteral(" [truncated]");
+    LogRecord shortened;
+    shortened.timestamp = record.timestamp;
+    shortened.threadId = record.threadId;
+    shortened.level = record.level;
+    shortened.category = record.category;
+    shortened.message = messageText(record);
+    shortened.message.truncate((BinaryLog::MaxFramePayload - FrameReserve) / 3 - marker.size());
+    shortened.message += marker;
+    return shortened;
+}
+
+void VoltLogger::writeBinary(const LogRecord& input) {
+    LogRecord shortened;
+    if (!fitsInFrame(input)) {
+        shortened = truncatedRecord(input);
+    }
+    const LogRecord& record = shortened.message.isEmpty() ? input : shortened;
+    
+    if (appendBinary(record)) {
+        return;
+    }
+    
+    // Segment full: start a new one, its definitions start over
+    {
+        std::lock_guard<std::mutex> lock(m_segmentMutex);
+        m_segment.rotate();
+        m_definitions.clear();
+    }
+    m_formatIds.clear();
+    m_categoryIds.clear();
+    
+    //? Records are cut to the frame size above, so a fresh segment always takes them
+    if (!appendBinary(record)) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool VoltLogger::appendBinary(const LogRecord& record) {
+    quint32 categoryId = m_categoryIds.value(record.category);
+    if (categoryId == 0) {
+        categoryId = quint32(qMax<qsizetype>(1, m_definitions.categories.size()));
+        if (!m_segment.append(BinaryLog::FrameCategory, BinaryLog::encodeDefinition(categoryId, record.category))) {
+            return false;
+        }
+        m_categoryIds.insert(record.category, categoryId);
+        std::lock_guard<std::mutex> lock(m_segmentMutex);
+        m_definitions.define(BinaryLog::FrameCategory, categoryId, record.category, BinaryLog::StylePercent);
+    }
+    
+    quint32 formatId = BinaryLog::PreformattedFormatId;
+    QByteArray preformatted;
+    if (record.format) {
+        formatId = m_formatIds.value(record.format);
+        if (formatId == 0) {
+            QString text = QString::fromUtf8(record.format);
+            formatId = quint32(qMax<qsizetype>(1, m_definitions.formats.size()));
+            if (!m_segment.append(BinaryLog::FrameFormat, BinaryLog::encodeDefinition(formatId, text, record.style))) {
+                return false;
+            }
+            m_formatIds.insert(record.format, formatId);
+            std::lock_guard<std::mutex> lock(m_segmentMutex);
+            m_definitions.define(BinaryLog::FrameFormat, formatId, text, record.style);
+        }
+    } else {
+        BinaryLog::appendArg(preformatted, record.message);
+    }
+    
+    QByteArray payload = BinaryLog::encodeRecord(record.timestamp - m_segment.baseTimestamp(), record.level,
+                                                 categoryId, formatId, record.threadId,
+                                                 record.format ? record.argCount : 1,
+                                                 record.format ? record.args : preformatted);
+    return m_segment.append(BinaryLog::FrameRecord, payload);
+}
+
+void VoltLogger::writeSessionText(const QString& text) {
+    if (m_logFile) {
+        m_logFile->write(text.toUtf8() + "\n");
+        m_logFile->flush();
+    } else if (m_segment.isOpen()) {
+        LogRecord record;
+        record.timestamp = QDateTime::currentMSecsSinceEpoch();
+        record.threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+        record.category = "SESSION";
+        record.message = text;
+        writeBinary(record);
+    }
+}
+
+void VoltLogger::writeOut(const QByteArray& text) {
+    if (m_fileEnabled.load(std::memory_order_relaxed) && m_logFile) {
+        m_logFile->write(text);
+        m_logFileSize += text.size();
+    }
+    if (m_consoleEnabled.load(std::memory_order_relaxed)) {
+        std::cout.write(text.constData(), text.size());
+    }
+}
+
+void VoltLogger::flush() {
+    if (!m_initialized.load(std::memory_order_acquire) || std::this_thread::get_id() == m_writer.get_id()) {
+        return;
+    }
+    
+    quint64 ticket;
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        ticket = m_flushRequested.fetch_add(1, std::memory_order_acq_rel) + 1;
+    }
+    m_wakeup.notify_one();
+    
+    std::unique_lock<std::mutex> lock(m_flushMutex);
+    m_flushed.wait(lock, [this, ticket]() {
+        return m_flushCompleted >= ticket || !m_initialized.load(std::memory_order_acquire);
+    });
+}
+
+QString VoltLogger::messageText(const LogRecord& record) {
+    if (!record.format) {
+        return record.message;
+    }
+    return BinaryLog::formatMessage(QString::fromUtf8(record.format), record.style,
+                                    BinaryLog::decodeArgs(record.args));
+}
+
+QString VoltLogger::levelToString(LogLevel level) {
+    return BinaryLog::levelName(level);
 }
 
 QString VoltLogger::levelToColorCode(LogLevel level) {
@@ -218,61 +617,110 @@ void VoltLogger::system(const QString& message, LogLevel level) {
 
 // Configuration methods
 void VoltLogger::setLogLevel(LogLevel level) {
-    QMutexLocker locker(&m_mutex);
-    m_minLevel = level;
+    //! No lock here: info() below logs through the same path and used to deadlock on m_mutex
+    m_minLevel.store(level, std::memory_order_relaxed);
     info(QString("Log level changed to: %1").arg(levelToString(level)), "CONFIG");
 }
 
 void VoltLogger::enableConsoleOutput(bool enable) {
-    QMutexLocker locker(&m_mutex);
-    m_consoleEnabled = enable;
+    m_consoleEnabled.store(enable, std::memory_order_relaxed);
 }
 
 void VoltLogger::enableFileOutput(bool enable) {
+    m_fileEnabled.store(enable, std::memory_order_relaxed);
+}
+
+void VoltLogger::setOverflowPolicy(OverflowPolicy policy) {
+    m_overflowPolicy.store(policy, std::memory_order_relaxed);
+}
+
+void VoltLogger::setBinaryLog(bool enable) {
     QMutexLocker locker(&m_mutex);
-    m_fileEnabled = enable;
+    if (!m_initialized.load()) {
+        m_binaryLog = enable;
+    }
 }
 
 QString VoltLogger::getRecentLogs(int lines) {
-    QMutexLocker locker(&m_mutex);
+    // Records still queued would be missing from the file
+    flush();
     
-    if (!m_logFile || !m_logFile->exists()) {
-        return "No log file available";
+    //* No logger lock below: writers keep going while the tail is read *//
+    if (m_binaryLog) {
+        // Decoded straight from the mapped segment, newest frames first
+        std::lock_guard<std::mutex> lock(m_segmentMutex);
+        if (!m_segment.isOpen()) {
+            return "No log file available";
+        }
+        QStringList recentLines;
+        const QVector<BinaryLog::Record> records =
+            BinaryLog::tailRecords(m_segment.data(), m_segment.usedSize(), lines);
+        for (const BinaryLog::Record& record : records) {
+            recentLines.append(m_definitions.line(record));
+        }
+        return recentLines.join("\n");
     }
     
-    // Read the file and return last N lines
-    QFile file(m_logFilePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        return "Cannot read log file";
+    {
+        // Usually served from memory
+        std::lock_guard<std::mutex> lock(m_recentMutex);
+        if (lines <= m_recentLines.size()) {
+            QStringList recentLines;
+            recentLines.reserve(lines);
+            qsizetype size = m_recentLines.size();
+            for (qsizetype i = size - lines; i < size; ++i) {
+                recentLines.append(m_recentLines[(m_recentHead + i) % size]);
+            }
+            return recentLines.join("\n");
+        }
     }
     
-    QStringList allLines;
-    QTextStream stream(&file);
-    while (!stream.atEnd()) {
-        allLines.append(stream.readLine());
+    if (!QFile::exists(m_logFilePath)) {
+        return "No log file available";
     }
     
-    // Return last N lines
-    int startIndex = qMax(0, allLines.size() - lines);
-    QStringList recentLines = allLines.mid(startIndex);
+    // Older history: the current file from its end, then the last rotated one
+    std::lock_guard<std::mutex> lock(m_rotateMutex);
+    QStringList recentLines = readTailLines(m_logFilePath, lines);
+    int missing = lines - int(recentLines.size());
+    if (missing > 0) {
+        QString pending = m_logFilePath + ".1";
+        QStringList older = QFile::exists(pending) ? readTailLines(pending, missing)
+                                                   : readCompressedTail(rotatedLogPath(1), missing);
+        recentLines = older + recentLines;
+    }
     
     return recentLines.join("\n");
 }
 
 void VoltLogger::shutdown() {
-    if (!m_initialized) return;
-    
-    endSession();
+    QMutexLocker locker(&m_mutex);
+    if (!m_initialized.load()) return;
     
-    if (m_logStream) {
-        m_logStream->flush();
-        m_logStream.reset();
+    // Stop accepting records, then let the writer drain what is queued
+    m_initialized.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stopWriter.store(true, std::memory_order_release);
+    }
+    m_wakeup.notify_one();
+    if (m_writer.joinable()) {
+        m_writer.join();
+    }
+    {
+        // Wakes flush() callers that raced with the shutdown
+        std::lock_guard<std::mutex> lock(m_flushMutex);
     }
+    m_flushed.notify_all();
+    
+    endSession();
     
     if (m_logFile) {
         m_logFile->close();
         m_logFile.reset();
     }
-    
-    m_initialized = false;
+    {
+        std::lock_guard<std::mutex> lock(m_segmentMutex);
+        m_segment.close();
+    }
 }
@@ -1,12 +1,35 @@
 #pragma once
 
 #include <QString>
-#include <QTextStream>
 #include <QFile>
 #include <QDateTime>
 #include <QMutex>
 #include <QDebug>
+#include <QHash>
+#include <QStringEncoder>
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
+
+#include "BinaryLog.h"
+#include "LogRing.h"
+
+/*
+ * Asynchronous logger.
+ *
+ * log() only stamps the record and pushes it onto a lock-free ring; a writer
+ * thread formats the lines and writes them in batches to the file and the
+ * console. The file is flushed on a timer, on ERROR/FATAL and on flush().
+ * When the ring is full, records below ERROR are dropped and counted by
+ * default, or the caller waits for room with the Block policy.
+ *
+ * The VOLT_*_F and VOLT_*_FMT macros do not format on the calling thread: the
+ * record carries the format literal and the raw arguments, and the writer
+ * formats them. With setBinaryLog(true) the file is a BinaryLog segment
+ * instead of text, read back with the volt_logdecode tool.
+ */
 
 class VoltLogger {
 public:
@@ -19,6 +42,11 @@ public:
         FATAL = 5
     };
 
+    enum OverflowPolicy {
+        DropNewest,
+        Block
+    };
+
     // Singleton instance
     static VoltLogger& instance();
     
@@ -45,51 +73,61 @@ public:
     // Template methods for formatting with arguments (Qt-style)
     template<typename T1>
     void debugf(const QString& format, T1 arg1) {
+        if (!isEnabled(DEBUG)) return;
         log(DEBUG, QString(format).arg(arg1), "APP");
     }
     
     template<typename T1, typename T2>
     void debugf(const QString& format, T1 arg1, T2 arg2) {
+        if (!isEnabled(DEBUG)) return;
         log(DEBUG, QString(format).arg(arg1).arg(arg2), "APP");
     }
     
     template<typename T1, typename T2, typename T3>
     void debugf(const QString& format, T1 arg1, T2 arg2, T3 arg3) {
+        if (!isEnabled(DEBUG)) return;
         log(DEBUG, QString(format).arg(arg1).arg(arg2).arg(arg3), "APP");
     }
     
     template<typename T1, typename T2, typename T3, typename T4>
     void debugf(const QString& format, T1 arg1, T2 arg2, T3 arg3, T4 arg4) {
+        if (!isEnabled(DEBUG)) return;
         log(DEBUG, QString(format).arg(arg1).arg(arg2).arg(arg3).arg(arg4), "APP");
     }
     
     template<typename T1>
     void infof(const QString& format, T1 arg1) {
+        if (!isEnabled(INFO)) return;
         log(INFO, QString(format).arg(arg1), "APP");
     }
     
     template<typename T1, typename T2>
     void infof(const QString& format, T1 arg1, T2 arg2) {
+        if (!isEnabled(INFO)) return;
         log(INFO, QString(format).arg(arg1).arg(arg2), "APP");
     }
     
     template<typename T1>
     void warnf(const QString& format, T1 arg1) {
+        if (!isEnabled(WARN)) return;
         log(WARN, QString(format).arg(arg1), "APP");
     }
     
     template<typename T1, typename T2>
     void warnf(const QString& format, T1 arg1, T2 arg2) {
+        if (!isEnabled(WARN)) return;
         log(WARN, QString(format).arg(arg1).arg(arg2), "APP");
     }
     
     template<typename T1>
     void errorf(const QString& format, T1 arg1) {
+        if (!isEnabled(ERROR)) return;
         log(ERROR, QString(format).arg(arg1), "APP");
     }
     
     template<typename T1, typename T2>
     void errorf(const QString& format, T1 arg1, T2 arg2) {
+        if (!isEnabled(ERROR)) return;
         log(ERROR, QString(format).arg(arg1).arg(arg2), "APP");
     }
     
@@ -97,6 +135,14 @@ public:
     void setLogLevel(LogLevel level);
     void enableConsoleOutput(bool enable);
     void enableFileOutput(bool enable);
+    void setOverflowPolicy(OverflowPolicy policy);
+    
+    // Must be called before initialize(); the log goes to <name>.vlog next to the text log path
+    void setBinaryLog(bool enable);
+    bool isBinaryLog() const { return m_binaryLog; }
+    
+    // Blocks until every record logged before the call is written and flushed
+    void flush();
     
     // Session management
     void startSession();
@@ -110,64 +156,186 @@ public:
     
     // Public access to core logging function for macros
     void log(LogLevel level, const QString& message, const QString& category);
+    
+    // Deferred formatting for the macros, format must be a string literal
+    template<typename... Args>
+    void logFormat(LogLevel level, const QString& category, BinaryLog::FormatStyle style,
+                   const char* format, const Args&... args) {
+        if (!isEnabled(level)) return;
+        LogRecord record;
+        record.format = format;
+        record.style = style;
+        record.argCount = quint8(sizeof...(Args));
+        (BinaryLog::appendArg(record.args, args), ...);
+        submit(level, category, record);
+    }
+    
+    // Cheap check the macros run before building a message
+    bool isEnabled(LogLevel level) const {
+        return m_initialized.load(std::memory_order_relaxed) && level >= m_minLevel.load(std::memory_order_relaxed);
+    }
+
+    static constexpr size_t QueueCapacity = 8192;
+    static constexpr int MaxBatchRecords = 1024;
+    static constexpr int FlushIntervalMs = 200;
+    static constexpr qint64 BinarySegmentSize = 8 * 1024 * 1024;
+    static constexpr int RecentLinesCapacity = 1000;
+    // Room for a record frame's header varints and string tag
+    static constexpr int FrameReserve = 64;
+    static constexpr qint64 MaxLogFileSize = 16 * 1024 * 1024;
+    static constexpr qint64 MaxLogFileAgeMs = 24 * 60 * 60 * 1000;
+    static constexpr int MaxRotatedLogs = 5;
 
 private:
+    struct LogRecord {
+        qint64 timestamp = 0;
+        quintptr threadId = 0;
+        LogLevel level = INFO;
+        QString category;
+        QString message;
+        
+        // Set for deferred records, message is empty then
+        const char* format = nullptr;
+        BinaryLog::FormatStyle style = BinaryLog::StylePercent;
+        quint8 argCount = 0;
+        QByteArray args;
+    };
+
     VoltLogger() = default;
     ~VoltLogger();
     
     // Helper functions
-    QString formatLogEntry(LogLevel level, const QString& message, const QString& category);
+    void submit(LogLevel level, const QString& category, LogRecord& record);
+    void enqueue(LogRecord& record);
+    void writerLoop();
+    void wakeWriter();
+    void writeOut(const QByteArray& text);
+    void writeRecord(const LogRecord& record, QByteArray& batch);
+    void rotateIfNeeded();
+    QString rotatedLogPath(int index) const;
+    void writeBinary(const LogRecord& input);
+    bool appendBinary(const LogRecord& record);
+    static bool fitsInFrame(const LogRecord& record);
+    LogRecord truncatedRecord(const LogRecord& record);
+    void writeSessionText(const QString& text);
+    QString messageText(const LogRecord& record);
     QString levelToString(LogLevel level);
     QString levelToColorCode(LogLevel level);
     
     // Member variables
     std::unique_ptr<QFile> m_logFile;
-    std::unique_ptr<QTextStream> m_logStream;
     QMutex m_mutex;
-    LogLevel m_minLevel = DEBUG;
-    bool m_consoleEnabled = true;
-    bool m_fileEnabled = true;
-    bool m_initialized = false;
+    std::atomic<int> m_minLevel{DEBUG};
+    std::atomic<bool> m_consoleEnabled{true};
+    std::atomic<bool> m_fileEnabled{true};
+    std::atomic<bool> m_initialized{false};
+    std::atomic<int> m_overflowPolicy{DropNewest};
     QString m_logFilePath;
+    bool m_binaryLog = false;
+    
+    // Text log rotation, the writer owns the counters; m_rotateMutex keeps
+    // tail reads away from files being renamed
+    qint64 m_logFileSize = 0;
+    qint64 m_logFileOpened = 0;
+    std::mutex m_rotateMutex;
+    
+    // Writer-thread scratch for formatting text lines, reused record to record
+    QString m_lineBuffer;
+    QStringEncoder m_lineEncoder{QStringEncoder::Utf8, QStringConverter::Flag::Stateless};
+    
+    // Newest formatted lines, a ring once full; m_recentHead is the oldest
+    QVector<QString> m_recentLines;
+    qsizetype m_recentHead = 0;
+    std::mutex m_recentMutex;
+
+    // Producer to writer hand-off
+    LogRing<LogRecord> m_queue{QueueCapacity};
+    std::atomic<quint64> m_dropped{0};
+    std::thread m_writer;
+    std::atomic<bool> m_stopWriter{false};
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeup;
+
+    // flush() takes a ticket and waits until the writer has completed it
+    std::atomic<quint64> m_flushRequested{0};
+    quint64 m_flushCompleted = 0;
+    std::mutex m_flushMutex;
+    std::condition_variable m_flushed;
+    
+    // Binary mode: ids are per segment and reset on rotation. The writer owns
+    // the id maps; m_definitions and rotation are guarded by m_segmentMutex
+    // so getRecentLogs() can decode the tail.
+    BinaryLog::SegmentWriter m_segment;
+    QHash<const char*, quint32> m_formatIds;
+    QHash<QString, quint32> m_categoryIds;
+    BinaryLog::Definitions m_definitions;
+    std::mutex m_segmentMutex;
     
     // Session tracking
     QDateTime m_sessionStart;
     int m_logCount = 0;
 };
 
+// Lowest level compiled in, set from CMake with -DVOLT_LOG_MIN_LEVEL=<TRACE|DEBUG|INFO|WARN|ERROR|FATAL|AUTO>
+#ifndef VOLT_LOG_MIN_LEVEL
+#define VOLT_LOG_MIN_LEVEL 0
+#endif
+
+// The level is checked before the message expression is evaluated, so disabled
+// messages never format or allocate. Levels below VOLT_LOG_MIN_LEVEL are a
+// constant false condition and drop out of the build entirely.
+#define VOLT_LOG_IF(level, category, message)                                                  \
+    do {                                                                                       \
+        if ((level) >= VOLT_LOG_MIN_LEVEL && VoltLogger::instance().isEnabled(level)) {        \
+            VoltLogger::instance().log((level), (message), QStringLiteral(category));          \
+        }                                                                                      \
+    } while (0)
+
 // Convenience macros (Winston-style)
-#define VOLT_TRACE(msg) VoltLogger::instance().trace(msg)
-#define VOLT_DEBUG(msg) VoltLogger::instance().debug(msg)
-#define VOLT_INFO(msg) VoltLogger::instance().info(msg)
-#define VOLT_WARN(msg) VoltLogger::instance().warn(msg)
-#define VOLT_ERROR(msg) VoltLogger::instance().error(msg)
-#define VOLT_FATAL(msg) VoltLogger::instance().fatal(msg)
+#define VOLT_TRACE(msg) VOLT_LOG_IF(VoltLogger::TRACE, "APP", msg)
+#define VOLT_DEBUG(msg) VOLT_LOG_IF(VoltLogger::DEBUG, "APP", msg)
+#define VOLT_INFO(msg) VOLT_LOG_IF(VoltLogger::INFO, "APP", msg)
+#define VOLT_WARN(msg) VOLT_LOG_IF(VoltLogger::WARN, "APP", msg)
+#define VOLT_ERROR(msg) VOLT_LOG_IF(VoltLogger::ERROR, "APP", msg)
+#define VOLT_FATAL(msg) VOLT_LOG_IF(VoltLogger::FATAL, "APP", msg)
 
 // Category-specific macros
-#define VOLT_THEME(msg) VoltLogger::instance().theme(msg)
-#define VOLT_UI(msg) VoltLogger::instance().ui(msg)
-#define VOLT_EDITOR(msg) VoltLogger::instance().editor(msg)
-#define VOLT_SYSTEM(msg) VoltLogger::instance().system(msg)
-
-// Formatted logging macros (simpler approach)
-#define VOLT_TRACE_F(fmt, arg1) VoltLogger::instance().log(VoltLogger::TRACE, QString(fmt).arg(arg1), "APP")
-#define VOLT_DEBUG_F(fmt, arg1) VoltLogger::instance().log(VoltLogger::DEBUG, QString(fmt).arg(arg1), "APP")
-#define VOLT_INFO_F(fmt, arg1) VoltLogger::instance().log(VoltLogger::INFO, QString(fmt).arg(arg1), "APP")
-#define VOLT_WARN_F(fmt, arg1) VoltLogger::instance().log(VoltLogger::WARN, QString(fmt).arg(arg1), "APP")
-#define VOLT_ERROR_F(fmt, arg1) VoltLogger::instance().log(VoltLogger::ERROR, QString(fmt).arg(arg1), "APP")
-#define VOLT_SYSTEM_F(fmt, arg1) VoltLogger::instance().log(VoltLogger::INFO, QString(fmt).arg(arg1), "SYSTEM")
-#define VOLT_THEME_F(fmt, arg1) VoltLogger::instance().log(VoltLogger::DEBUG, QString(fmt).arg(arg1), "THEME")
-
-// Two-argument versions
-#define VOLT_TRACE_F2(fmt, arg1, arg2) VoltLogger::instance().log(VoltLogger::TRACE, QString(fmt).arg(arg1).arg(arg2), "APP")
-#define VOLT_DEBUG_F2(fmt, arg1, arg2) VoltLogger::instance().log(VoltLogger::DEBUG, QString(fmt).arg(arg1).arg(arg2), "APP")
-#define VOLT_INFO_F2(fmt, arg1, arg2) VoltLogger::instance().log(VoltLogger::INFO, QString(fmt).arg(arg1).arg(arg2), "APP")
-#define VOLT_WARN_F2(fmt, arg1, arg2) VoltLogger::instance().log(VoltLogger::WARN, QString(fmt).arg(arg1).arg(arg2), "APP")
-#define VOLT_THEME_F2(fmt, arg1, arg2) VoltLogger::instance().log(VoltLogger::DEBUG, QString(fmt).arg(arg1).arg(arg2), "THEME")
-
-// Three-argument versions
-#define VOLT_TRACE_F3(fmt, arg1, arg2, arg3) VoltLogger::instance().log(VoltLogger::TRACE, QString(fmt).arg(arg1).arg(arg2).arg(arg3), "APP")
-#define VOLT_DEBUG_F3(fmt, arg1, arg2, arg3) VoltLogger::instance().log(VoltLogger::DEBUG, QString(fmt).arg(arg1).arg(arg2).arg(arg3), "APP")
-
-// Four-argument versions
-#define VOLT_DEBUG_F4(fmt, arg1, arg2, arg3, arg4) VoltLogger::instance().log(VoltLogger::DEBUG, QString(fmt).arg(arg1).arg(arg2).arg(arg3).arg(arg4), "APP")
+#define VOLT_THEME(msg) VOLT_LOG_IF(VoltLogger::DEBUG, "THEME", msg)
+#define VOLT_UI(msg) VOLT_LOG_IF(VoltLogger::DEBUG, "UI", msg)
+#define VOLT_EDITOR(msg) VOLT_LOG_IF(VoltLogger::DEBUG, "EDITOR", msg)
+#define VOLT_SYSTEM(msg) VOLT_LOG_IF(VoltLogger::INFO, "SYSTEM", msg)
+
+// Same gate for deferred records; the first variadic argument is the format literal
+#define VOLT_LOG_FORMAT(level, category, style, ...)                                           \
+    do {                                                                                       \
+        if ((level) >= VOLT_LOG_MIN_LEVEL && VoltLogger::instance().isEnabled(level)) {        \
+            VoltLogger::instance().logFormat((level), QStringLiteral(category), (style), __VA_ARGS__); \
+        }                                                                                      \
+    } while (0)
+
+// Formatted logging macros, Qt-style %1 placeholders, any number of arguments
+#define VOLT_TRACE_F(...) VOLT_LOG_FORMAT(VoltLogger::TRACE, "APP", BinaryLog::StylePercent, __VA_ARGS__)
+#define VOLT_DEBUG_F(...) VOLT_LOG_FORMAT(VoltLogger::DEBUG, "APP", BinaryLog::StylePercent, __VA_ARGS__)
+#define VOLT_INFO_F(...) VOLT_LOG_FORMAT(VoltLogger::INFO, "APP", BinaryLog::StylePercent, __VA_ARGS__)
+#define VOLT_WARN_F(...) VOLT_LOG_FORMAT(VoltLogger::WARN, "APP", BinaryLog::StylePercent, __VA_ARGS__)
+#define VOLT_ERROR_F(...) VOLT_LOG_FORMAT(VoltLogger::ERROR, "APP", BinaryLog::StylePercent, __VA_ARGS__)
+#define VOLT_SYSTEM_F(...) VOLT_LOG_FORMAT(VoltLogger::INFO, "SYSTEM", BinaryLog::StylePercent, __VA_ARGS__)
+#define VOLT_THEME_F(...) VOLT_LOG_FORMAT(VoltLogger::DEBUG, "THEME", BinaryLog::StylePercent, __VA_ARGS__)
+#define VOLT_PERF_F(...) VOLT_LOG_FORMAT(VoltLogger::WARN, "PERF", BinaryLog::StylePercent, __VA_ARGS__)
+
+// Numbered versions, kept for existing call sites
+#define VOLT_TRACE_F2 VOLT_TRACE_F
+#define VOLT_DEBUG_F2 VOLT_DEBUG_F
+#define VOLT_INFO_F2 VOLT_INFO_F
+#define VOLT_WARN_F2 VOLT_WARN_F
+#define VOLT_THEME_F2 VOLT_THEME_F
+#define VOLT_TRACE_F3 VOLT_TRACE_F
+#define VOLT_DEBUG_F3 VOLT_DEBUG_F
+#define VOLT_DEBUG_F4 VOLT_DEBUG_F
+
+// {}-style placeholders
+#define VOLT_TRACE_FMT(...) VOLT_LOG_FORMAT(VoltLogger::TRACE, "APP", BinaryLog::StyleBrace, __VA_ARGS__)
+#define VOLT_DEBUG_FMT(...) VOLT_LOG_FORMAT(VoltLogger::DEBUG, "APP", BinaryLog::StyleBrace, __VA_ARGS__)
+#define VOLT_INFO_FMT(...) VOLT_LOG_FORMAT(VoltLogger::INFO, "APP", BinaryLog::StyleBrace, __VA_ARGS__)
+#define VOLT_WARN_FMT(...) VOLT_LOG_FORMAT(VoltLogger::WARN, "APP", BinaryLog::StyleBrace, __VA_ARGS__)
+#define VOLT_ERROR_FMT(...) VOLT_LOG_FORMAT(VoltLogger::ERROR, "APP", BinaryLog::StyleBrace, __VA_ARGS__)
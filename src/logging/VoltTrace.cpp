@@ -0,0 +1,203 @@
+#include "VoltTrace.h"
+#include <QAbstractEventDispatcher>
+#include <QCoreApplication>
+#include <QFile>
+#include <QThread>
+
+namespace {
+
+thread_local void* t_buffer = nullptr;
+
+//* Event loop iterations shorter than this only add noise to the trace *//
+constexpr qint64 MinLoopSpanUs = 100;
+
+void appendJsonString(QByteArray& out, const QByteArray& text) {
+    out += '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    out += '"';
+}
+
+}
+
+VoltTrace& VoltTrace::instance() {
+    static VoltTrace instance;
+    return instance;
+}
+
+VoltTrace::VoltTrace()
+    : m_origin(std::chrono::steady_clock::now()) {
+}
+
+void VoltTrace::start(const QString& outputPath) {
+    {
+        std::lock_guard<std::mutex> lock(m_buffersMutex);
+        for (const auto& buffer : m_buffers) {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            buffer->events.clear();
+            buffer->dropped = 0;
+        }
+    }
+    m_outputPath = outputPath;
+    m_enabled.store(true, std::memory_order_release);
+}
+
+bool VoltTrace::stop() {
+    if (!m_enabled.exchange(false)) {
+        return false;
+    }
+    return m_outputPath.isEmpty() || writeJson(m_outputPath);
+}
+
+qint64 VoltTrace::nowUs() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_origin).count();
+}
+
+/*
+ * Buffers are created on a thread's first span and live as long as the
+ * tracer, so the thread-local pointer never dangles, even across stop/start.
+ */
+VoltTrace::ThreadBuffer* VoltTrace::currentBuffer() {
+    if (t_buffer) {
+        return static_cast<ThreadBuffer*>(t_buffer);
+    }
+
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->threadId = quint64(reinterpret_cast<quintptr>(QThread::currentThreadId()));
+    QCoreApplication* app = QCoreApplication::instance();
+    bool isMain = app && QThread::currentThread() == app->thread();
+    if (isMain) {
+        buffer->threadName = "main";
+    } else {
+        buffer->threadName = QThread::currentThread()->objectName();
+        if (buffer->threadName.isEmpty()) {
+            buffer->threadName = QString("thread %1").arg(buffer->threadId);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_buffersMutex);
+    m_buffers.push_back(std::move(buffer));
+    t_buffer = m_buffers.back().get();
+    if (isMain) {
+        m_mainBuffer.store(m_buffers.back().get(), std::memory_order_release);
+    }
+    return m_buffers.back().get();
+}
+
+const char* VoltTrace::mainThreadSpan() const {
+    ThreadBuffer* buffer = m_mainBuffer.load(std::memory_order_acquire);
+    return buffer ? buffer->activeName.load(std::memory_order_relaxed) : nullptr;
+}
+
+void VoltTrace::record(ThreadBuffer* buffer, const Event& event) {
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    if (buffer->events.size() >= MaxEventsPerThread) {
+        ++buffer->dropped;
+        return;
+    }
+    buffer->events.push_back(event);
+}
+
+void VoltTrace::beginSpan(const char* name, const char* category) {
+    ThreadBuffer* buffer = currentBuffer();
+    buffer->open.push_back({name, category, nowUs()});
+    buffer->activeName.store(name, std::memory_order_relaxed);
+}
+
+void VoltTrace::endSpan() {
+    ThreadBuffer* buffer = currentBuffer();
+    if (buffer->open.empty()) {
+        return;
+    }
+
+    OpenSpan span = buffer->open.back();
+    buffer->open.pop_back();
+    buffer->activeName.store(buffer->open.empty() ? nullptr : buffer->open.back().name, std::memory_order_relaxed);
+    //? Spans that end after stop() are not recorded
+    if (isEnabled()) {
+        record(buffer, {span.name, span.category, span.startUs, nowUs() - span.startUs});
+    }
+}
+
+void VoltTrace::addComplete(const char* name, const char* category, qint64 startUs, qint64 endUs) {
+    if (!isEnabled()) {
+        return;
+    }
+    record(currentBuffer(), {name, category, startUs, endUs - startUs});
+}
+
+void VoltTrace::instrumentEventLoop() {
+    QAbstractEventDispatcher* dispatcher = QAbstractEventDispatcher::instance();
+    if (!dispatcher || m_eventLoopInstrumented) {
+        return;
+    }
+    m_eventLoopInstrumented = true;
+
+    //* Both signals come from the main thread's dispatcher, m_loopStartUs is only touched there *//
+    QObject::connect(dispatcher, &QAbstractEventDispatcher::awake, dispatcher, [this]() {
+        if (isEnabled() && m_loopStartUs < 0) {
+            m_loopStartUs = nowUs();
+        }
+    });
+    QObject::connect(dispatcher, &QAbstractEventDispatcher::aboutToBlock, dispatcher, [this]() {
+        if (m_loopStartUs < 0) {
+            return;
+        }
+        qint64 endUs = nowUs();
+        if (endUs - m_loopStartUs >= MinLoopSpanUs) {
+            addComplete("EventLoop", "loop", m_loopStartUs, endUs);
+        }
+        m_loopStartUs = -1;
+    });
+}
+
+bool VoltTrace::writeJson(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    QByteArray json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto separator = [&]() {
+        if (!first) {
+            json += ",\n";
+        }
+        first = false;
+    };
+
+    std::lock_guard<std::mutex> lock(m_buffersMutex);
+    for (const auto& buffer : m_buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        QByteArray tid = QByteArray::number(buffer->threadId);
+
+        separator();
+        json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"name\":";
+        appendJsonString(json, buffer->threadName.toUtf8());
+        json += "}}";
+
+        for (const Event& event : buffer->events) {
+            separator();
+            json += "{\"name\":";
+            appendJsonString(json, QByteArray(event.name));
+            json += ",\"cat\":";
+            appendJsonString(json, QByteArray(event.category));
+            json += ",\"ph\":\"X\",\"ts\":" + QByteArray::number(event.startUs);
+            json += ",\"dur\":" + QByteArray::number(event.durationUs);
+            json += ",\"pid\":1,\"tid\":" + tid + "}";
+        }
+
+        if (buffer->dropped > 0) {
+            separator();
+            json += "{\"name\":\"events dropped\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":" + tid;
+            json += ",\"ts\":0,\"args\":{\"count\":" + QByteArray::number(quint64(buffer->dropped)) + "}}";
+        }
+    }
+    json += "\n]}\n";
+
+    return file.write(json) == json.size();
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <QString>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/*
+ * Scoped-span tracer, exported as Chrome trace JSON (chrome://tracing, Perfetto).
+ *
+ * Each thread records into its own buffer, so recording only takes that
+ * buffer's uncontended lock. A span is stored once, when it ends, as a
+ * complete event with its start and duration. While tracing and scope
+ * tracking are off a scope costs two relaxed atomic loads.
+ *
+ * Span and category names must be string literals, only the pointers are kept.
+ */
+class VoltTrace {
+public:
+    static VoltTrace& instance();
+
+    // Starts recording; the trace is written to outputPath by stop()
+    void start(const QString& outputPath);
+    bool stop();
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    // Scopes also run while only tracking is on, so a watchdog can see the current span
+    void setScopeTracking(bool enable) { m_tracking.store(enable, std::memory_order_relaxed); }
+    bool isActive() const { return isEnabled() || m_tracking.load(std::memory_order_relaxed); }
+
+    // Innermost open span of the main thread, null when none; safe from any thread
+    const char* mainThreadSpan() const;
+
+    // Spans on the calling thread, they must nest
+    void beginSpan(const char* name, const char* category);
+    void endSpan();
+
+    // Span whose bounds were measured elsewhere, e.g. across event loop signals
+    void addComplete(const char* name, const char* category, qint64 startUs, qint64 endUs);
+
+    // Traces each event loop iteration on the main thread, between waking up and blocking again
+    void instrumentEventLoop();
+
+    // Microseconds since the trace clock origin
+    qint64 nowUs() const;
+
+    bool writeJson(const QString& path);
+
+    static constexpr size_t MaxEventsPerThread = 1 << 20;
+
+private:
+    struct Event {
+        const char* name;
+        const char* category;
+        qint64 startUs;
+        qint64 durationUs;
+    };
+
+    struct OpenSpan {
+        const char* name;
+        const char* category;
+        qint64 startUs;
+    };
+
+    struct ThreadBuffer {
+        quint64 threadId = 0;
+        QString threadName;
+        std::mutex mutex;
+        std::vector<Event> events;
+        std::vector<OpenSpan> open; // owner thread only
+        std::atomic<const char*> activeName{nullptr};
+        size_t dropped = 0;
+    };
+
+    VoltTrace();
+    ThreadBuffer* currentBuffer();
+    void record(ThreadBuffer* buffer, const Event& event);
+
+    std::atomic<bool> m_enabled{false};
+    std::atomic<bool> m_tracking{false};
+    std::atomic<ThreadBuffer*> m_mainBuffer{nullptr};
+    std::chrono::steady_clock::time_point m_origin;
+    QString m_outputPath;
+
+    std::mutex m_buffersMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+
+    bool m_eventLoopInstrumented = false;
+    qint64 m_loopStartUs = -1;
+};
+
+// RAII span; names the enclosing function's work for the trace
+class VoltTraceScope {
+public:
+    VoltTraceScope(const char* name, const char* category = "volt")
+        : m_active(VoltTrace::instance().isActive()) {
+        if (m_active) {
+            VoltTrace::instance().beginSpan(name, category);
+        }
+    }
+
+    ~VoltTraceScope() {
+        if (m_active) {
+            VoltTrace::instance().endSpan();
+        }
+    }
+
+    VoltTraceScope(const VoltTraceScope&) = delete;
+    VoltTraceScope& operator=(const VoltTraceScope&) = delete;
+
+private:
+    bool m_active;
+};
+
+#define VOLT_TRACE_CONCAT_INNER(a, b) a##b
+#define VOLT_TRACE_CONCAT(a, b) VOLT_TRACE_CONCAT_INNER(a, b)
+
+// Traces the rest of the enclosing block under the given literal name
+#define VOLT_TRACE_SCOPE(name) VoltTraceScope VOLT_TRACE_CONCAT(voltTraceScope_, __LINE__)(name)
+#define VOLT_TRACE_SCOPE_CAT(name, category) VoltTraceScope VOLT_TRACE_CONCAT(voltTraceScope_, __LINE__)(name, category)
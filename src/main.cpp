@@ -5,6 +5,8 @@
 #include "ui/MainWindow.h"
 #include "themes/Theme.h"
 #include "logging/VoltLogger.h"
+#include "logging/VoltTrace.h"
+#include "logging/UiWatchdog.h"
 #include <QIcon>
 #include <QFontDatabase>
 
@@ -21,9 +23,44 @@ int main(int argc, char *argv[])
     parser.setApplicationDescription("Volt Editor - A modern text editor");
     parser.addHelpOption();
     parser.addVersionOption();
-    parser.addPositionalArgument("file", "File or folder to open", "[file/folder]");
+    parser.addPositionalArgument("file", "Files or a folder to open", "[file.../folder]");
+
+    QCommandLineOption largeFileThresholdOption(
+        "large-file-threshold",
+        "Open files of at least <megabytes> in large file mode (default 64).",
+        "megabytes");
+    parser.addOption(largeFileThresholdOption);
+
+    QCommandLineOption noSearchIndexOption(
+        "no-search-index",
+        "Do not build an on-disk search index for the opened folder.");
+    parser.addOption(noSearchIndexOption);
+
+    QCommandLineOption binaryLogOption(
+        "binary-log",
+        "Write the log as a compact binary file (logs/volt.vlog), read it with volt_logdecode.");
+    parser.addOption(binaryLogOption);
+
+    QCommandLineOption traceOption(
+        "trace",
+        "Record a performance trace and write it as Chrome trace JSON to <file> on exit.",
+        "file");
+    parser.addOption(traceOption);
+
+    QCommandLineOption stallThresholdOption(
+        "stall-threshold",
+        "Log a PERF warning when the UI thread is blocked for <milliseconds> (default 250, 0 disables).",
+        "milliseconds");
+    parser.addOption(stallThresholdOption);
     parser.process(app);
 
+    if (parser.isSet(traceOption))
+    {
+        VoltTrace::instance().start(parser.value(traceOption));
+        VoltTrace::instance().instrumentEventLoop();
+    }
+
+    VoltLogger::instance().setBinaryLog(parser.isSet(binaryLogOption));
     VoltLogger::instance().initialize("logs/volt.log", VoltLogger::DEBUG, true, true);
 
     /*
@@ -71,23 +108,62 @@ int main(int argc, char *argv[])
 
     MainWindow window;
 
-    if (!fileToOpen.isEmpty())
+    if (parser.isSet(largeFileThresholdOption))
+    {
+        bool ok = false;
+        qint64 megabytes = parser.value(largeFileThresholdOption).toLongLong(&ok);
+        if (ok && megabytes > 0)
+        {
+            window.setLargeFileThreshold(megabytes * 1024 * 1024);
+        }
+        else
+        {
+            VOLT_WARN_F("Ignoring invalid --large-file-threshold value: %1", parser.value(largeFileThresholdOption));
+        }
+    }
+
+    if (parser.isSet(noSearchIndexOption))
+    {
+        window.setSearchIndexEnabled(false);
+    }
+
+    //* Every file becomes a tab, only the last one is loaded until the others are shown *//
+    QStringList filesToOpen;
+    for (const QString &path : positionalArgs)
     {
-        QFileInfo fileInfo(fileToOpen);
+        QFileInfo fileInfo(path);
         if (fileInfo.isFile())
         {
-            window.openFile(fileToOpen);
+            filesToOpen.append(path);
         }
-        else if (fileInfo.isDir())
+        else if (fileInfo.isDir() && path == fileToOpen)
         {
-            window.openFolder(fileToOpen);
+            window.openFolder(path);
         }
     }
+    window.openFiles(filesToOpen);
 
     window.show();
 
+    int stallThresholdMs = UiWatchdog::DefaultThresholdMs;
+    if (parser.isSet(stallThresholdOption))
+    {
+        stallThresholdMs = parser.value(stallThresholdOption).toInt();
+    }
+    if (stallThresholdMs > 0)
+    {
+        UiWatchdog::instance().start(stallThresholdMs);
+    }
+
     int result = app.exec();
 
+    UiWatchdog::instance().stop();
+
+    if (VoltTrace::instance().isEnabled() && !VoltTrace::instance().stop())
+    {
+        VOLT_ERROR_F("Failed to write trace: %1", parser.value(traceOption));
+    }
+
     VoltLogger::instance().shutdown();
 
     return result;
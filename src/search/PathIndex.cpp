@@ -0,0 +1,402 @@
+#include "PathIndex.h"
+#include "ProjectSearch.h"
+#include "../logging/VoltLogger.h"
+
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QSet>
+#include <QThread>
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+
+struct PathIndex::Snapshot
+{
+    QByteArray paths;
+    QByteArray lowerPaths;
+    std::vector<quint32> offsets;
+};
+
+namespace {
+
+//* Paths handed to one scoring thread at minimum, below that threads cost more than they save *//
+constexpr size_t MinPathsPerThread = 16 * 1024;
+
+constexpr int ScoreMatch = 16;
+constexpr int BonusFirstChar = 8;
+constexpr int BonusSeparator = 10;
+constexpr int BonusDelimiter = 8;
+constexpr int BonusCamelCase = 7;
+constexpr int BonusConsecutive = 5;
+constexpr int BonusBasename = 24;
+constexpr int PenaltyGapStart = 3;
+constexpr int PenaltyGapExtension = 1;
+
+inline char asciiLower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? char(c + ('a' - 'A')) : c;
+}
+
+/*
+ * Bonus for a match at position i: word starts after a path separator,
+ * after a delimiter, or at a camelCase hump score higher than mid-word hits.
+ */
+inline int boundaryBonus(const char *path, int i)
+{
+    if (i == 0)
+    {
+        return BonusSeparator;
+    }
+
+    char previous = path[i - 1];
+    char current = path[i];
+    if (previous == '/')
+    {
+        return BonusSeparator;
+    }
+    if (previous == '_' || previous == '-' || previous == '.' || previous == ' ')
+    {
+        return BonusDelimiter;
+    }
+    if (previous >= 'a' && previous <= 'z' && current >= 'A' && current <= 'Z')
+    {
+        return BonusCamelCase;
+    }
+    return 0;
+}
+
+/*
+ * fzf's v1 algorithm: a forward pass finds the first window that contains the
+ * query as a subsequence (one memchr per query character), a backward pass
+ * shrinks that window from its end, and the window is then scored with
+ * boundary and consecutive bonuses and gap penalties. Returns -1 when the
+ * query is not a subsequence of the path.
+ */
+int scorePath(const char *path, const char *lower, int length, const char *query, int queryLength)
+{
+    const char *p = lower;
+    const char *stop = lower + length;
+    int first = -1;
+    for (int qi = 0; qi < queryLength; ++qi)
+    {
+        p = static_cast<const char *>(std::memchr(p, query[qi], size_t(stop - p)));
+        if (!p)
+        {
+            return -1;
+        }
+        if (qi == 0)
+        {
+            first = int(p - lower);
+        }
+        ++p;
+    }
+    int end = int(p - lower);
+
+    int start = end - 1;
+    for (int qi = queryLength - 1; start >= first; --start)
+    {
+        if (lower[start] == query[qi] && --qi < 0)
+        {
+            break;
+        }
+    }
+
+    int score = 0;
+    int consecutive = 0;
+    bool inGap = false;
+    for (int i = start, qi = 0; i < end && qi < queryLength; ++i)
+    {
+        if (lower[i] == query[qi])
+        {
+            int bonus = boundaryBonus(path, i);
+            if (qi == 0)
+            {
+                bonus += BonusFirstChar;
+            }
+            if (consecutive > 0)
+            {
+                bonus = qMax(bonus, BonusConsecutive);
+            }
+            score += ScoreMatch + bonus;
+            ++consecutive;
+            inGap = false;
+            ++qi;
+        }
+        else
+        {
+            score -= inGap ? PenaltyGapExtension : PenaltyGapStart;
+            consecutive = 0;
+            inGap = true;
+        }
+    }
+
+    //* Matches inside the file name beat matches spread over the directories *//
+    int basename = length;
+    while (basename > 0 && path[basename - 1] != '/')
+    {
+        --basename;
+    }
+    if (start >= basename)
+    {
+        score += BonusBasename;
+    }
+
+    //* Among equals, shorter paths are usually what was meant *//
+    return score * 4 - length / 8;
+}
+
+struct Candidate
+{
+    int score;
+    int length;
+    quint32 id;
+};
+
+//* Heap order keeps the worst candidate on top so it can be replaced *//
+inline bool betterThan(const Candidate &a, const Candidate &b)
+{
+    if (a.score != b.score)
+    {
+        return a.score > b.score;
+    }
+    if (a.length != b.length)
+    {
+        return a.length < b.length;
+    }
+    return a.id < b.id;
+}
+
+}
+
+PathIndex::PathIndex(QObject *parent)
+    : QObject(parent), m_generation(0), m_cancelled(false), m_buildId(0)
+{
+}
+
+PathIndex::~PathIndex()
+{
+    stopBuild();
+}
+
+void PathIndex::setRootPath(const QString &rootPath)
+{
+    if (rootPath == m_rootPath && isReady())
+    {
+        return;
+    }
+
+    m_rootPath = rootPath;
+    m_paths.clear();
+    m_lowerPaths.clear();
+    m_offsets.clear();
+    ++m_generation;
+    refresh();
+}
+
+/*
+ * Rebuilds the index in the background. The current one keeps answering
+ * queries until the new one is swapped in.
+ */
+void PathIndex::refresh()
+{
+    stopBuild();
+    if (m_rootPath.isEmpty())
+    {
+        return;
+    }
+
+    quint64 buildId = ++m_buildId;
+    QString root = m_rootPath;
+    m_builder = std::thread([this, buildId, root]() {
+        QElapsedTimer timer;
+        timer.start();
+
+        SearchOptions defaults;
+        const QSet<QString> ignored(defaults.ignoredNames.begin(), defaults.ignoredNames.end());
+        const int prefix = root.size() + 1;
+
+        auto snapshot = std::make_shared<Snapshot>();
+        snapshot->offsets.push_back(0);
+
+        std::deque<QString> pending{root};
+        while (!pending.empty() && !m_cancelled.load(std::memory_order_relaxed))
+        {
+            QString dir = std::move(pending.front());
+            pending.pop_front();
+
+            QDirIterator it(dir, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks);
+            while (it.hasNext())
+            {
+                it.next();
+                QFileInfo info = it.fileInfo();
+                if (ignored.contains(info.fileName()))
+                {
+                    continue;
+                }
+
+                if (info.isDir())
+                {
+                    pending.push_back(info.filePath());
+                }
+                else
+                {
+                    QByteArray relative = info.filePath().mid(prefix).toUtf8();
+                    snapshot->paths.append(relative);
+                    for (char &c : relative)
+                    {
+                        c = asciiLower(c);
+                    }
+                    snapshot->lowerPaths.append(relative);
+                    snapshot->offsets.push_back(quint32(snapshot->paths.size()));
+                }
+            }
+        }
+
+        if (m_cancelled.load())
+        {
+            return;
+        }
+
+        VOLT_DEBUG_F2("PathIndex: %1 paths indexed in %2 ms", QString::number(snapshot->offsets.size() - 1),
+                      QString::number(timer.elapsed()));
+        QMetaObject::invokeMethod(this, [this, buildId, snapshot]() { install(buildId, snapshot); },
+                                  Qt::QueuedConnection);
+    });
+}
+
+void PathIndex::stopBuild()
+{
+    m_cancelled.store(true);
+    if (m_builder.joinable())
+    {
+        m_builder.join();
+    }
+    m_cancelled.store(false);
+
+    //* A build that finished but was not installed yet is dropped by its id *//
+    ++m_buildId;
+}
+
+void PathIndex::install(quint64 buildId, const std::shared_ptr<Snapshot> &snapshot)
+{
+    if (buildId != m_buildId)
+    {
+        return;
+    }
+    if (m_builder.joinable())
+    {
+        m_builder.join();
+    }
+
+    m_paths = std::move(snapshot->paths);
+    m_lowerPaths = std::move(snapshot->lowerPaths);
+    m_offsets = std::move(snapshot->offsets);
+    ++m_generation;
+    emit ready();
+}
+
+QString PathIndex::relativePath(quint32 id) const
+{
+    return QString::fromUtf8(m_paths.constData() + m_offsets[id], int(m_offsets[id + 1] - m_offsets[id]));
+}
+
+QString PathIndex::absolutePath(quint32 id) const
+{
+    return m_rootPath + QLatin1Char('/') + relativePath(id);
+}
+
+QVector<PathMatch> PathIndex::match(const QString &query, int topK, const std::vector<quint32> *subset,
+                                    std::vector<quint32> &matched) const
+{
+    matched.clear();
+    if (!isReady() || topK <= 0)
+    {
+        return {};
+    }
+
+    //* Spaces only separate words for the user, paths are matched without them *//
+    QByteArray needle = query.toUtf8();
+    needle.replace(' ', QByteArray());
+    for (char &c : needle)
+    {
+        c = asciiLower(c);
+    }
+
+    const size_t total = subset ? subset->size() : size_t(size());
+    if (needle.isEmpty())
+    {
+        return {};
+    }
+
+    int threadCount = int(qBound<size_t>(1, total / MinPathsPerThread, size_t(qMax(1, QThread::idealThreadCount()))));
+    std::vector<std::vector<Candidate>> heaps(size_t(threadCount));
+    std::vector<std::vector<quint32>> hits(size_t(threadCount));
+
+    //* Each thread scores a contiguous slice and keeps its own top K in a heap *//
+    auto work = [&](int slice) {
+        size_t begin = total * size_t(slice) / size_t(threadCount);
+        size_t end = total * size_t(slice + 1) / size_t(threadCount);
+        std::vector<Candidate> &heap = heaps[size_t(slice)];
+        std::vector<quint32> &found = hits[size_t(slice)];
+        heap.reserve(size_t(topK) + 1);
+
+        for (size_t i = begin; i < end; ++i)
+        {
+            quint32 id = subset ? (*subset)[i] : quint32(i);
+            quint32 offset = m_offsets[id];
+            int length = int(m_offsets[id + 1] - offset);
+            int score = scorePath(m_paths.constData() + offset, m_lowerPaths.constData() + offset, length,
+                                  needle.constData(), needle.size());
+            if (score < 0)
+            {
+                continue;
+            }
+
+            found.push_back(id);
+            Candidate candidate{score, length, id};
+            if (int(heap.size()) < topK)
+            {
+                heap.push_back(candidate);
+                std::push_heap(heap.begin(), heap.end(), betterThan);
+            }
+            else if (betterThan(candidate, heap.front()))
+            {
+                std::pop_heap(heap.begin(), heap.end(), betterThan);
+                heap.back() = candidate;
+                std::push_heap(heap.begin(), heap.end(), betterThan);
+            }
+        }
+    };
+
+    std::vector<std::thread> helpers;
+    for (int i = 1; i < threadCount; ++i)
+    {
+        helpers.emplace_back(work, i);
+    }
+    work(0);
+    for (std::thread &helper : helpers)
+    {
+        helper.join();
+    }
+
+    //* Slices are in id order, so the concatenation stays sorted for the next refinement *//
+    std::vector<Candidate> best;
+    for (int i = 0; i < threadCount; ++i)
+    {
+        matched.insert(matched.end(), hits[size_t(i)].begin(), hits[size_t(i)].end());
+        best.insert(best.end(), heaps[size_t(i)].begin(), heaps[size_t(i)].end());
+    }
+
+    size_t keep = qMin(best.size(), size_t(topK));
+    std::partial_sort(best.begin(), best.begin() + keep, best.end(), betterThan);
+
+    QVector<PathMatch> results;
+    results.reserve(int(keep));
+    for (size_t i = 0; i < keep; ++i)
+    {
+        results.append({best[i].id, best[i].score});
+    }
+    return results;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+struct PathMatch
+{
+    quint32 id;
+    int score;
+};
+
+/*
+ * Flat in-memory list of every file under a project root, for quick open.
+ *
+ * Paths are stored back to back in one buffer, once as written and once
+ * ASCII-lowercased, with an offset table next to them. Scoring walks the
+ * buffers linearly, which keeps 500k paths in a few tens of megabytes and
+ * the scan cache friendly.
+ *
+ * The index is built on a background thread and swapped in on the GUI
+ * thread once complete, ready() is emitted then.
+ */
+class PathIndex : public QObject
+{
+    Q_OBJECT
+public:
+    explicit PathIndex(QObject *parent = nullptr);
+    ~PathIndex();
+
+    void setRootPath(const QString &rootPath);
+    void refresh();
+    QString rootPath() const { return m_rootPath; }
+
+    bool isReady() const { return !m_offsets.empty(); }
+    int size() const { return m_offsets.empty() ? 0 : int(m_offsets.size() - 1); }
+    // Changes whenever a new build is swapped in, previous match sets are invalid afterwards
+    quint64 generation() const { return m_generation; }
+
+    QString relativePath(quint32 id) const;
+    QString absolutePath(quint32 id) const;
+
+    /*
+     * Scores every path (or only the ids in subset, which must come from an
+     * earlier match on this generation) against the query. The best topK
+     * matches are returned best first; every id that matched at all is stored
+     * in matched, so a longer query can be refined from it.
+     */
+    QVector<PathMatch> match(const QString &query, int topK, const std::vector<quint32> *subset,
+                             std::vector<quint32> &matched) const;
+
+signals:
+    void ready();
+
+private:
+    struct Snapshot;
+
+    void stopBuild();
+    void install(quint64 buildId, const std::shared_ptr<Snapshot> &snapshot);
+
+    QString m_rootPath;
+    QByteArray m_paths;
+    QByteArray m_lowerPaths;
+    std::vector<quint32> m_offsets;
+    quint64 m_generation;
+
+    std::thread m_builder;
+    std::atomic<bool> m_cancelled;
+    quint64 m_buildId;
+};
@@ -0,0 +1,598 @@
+#include "ProjectSearch.h"
+#include "../logging/VoltLogger.h"
+
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QSet>
+#include <QThread>
+
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <mutex>
+
+namespace {
+
+struct WorkItem
+{
+    QString path;
+    bool isDirectory;
+};
+
+struct WorkQueue
+{
+    std::mutex mutex;
+    std::deque<WorkItem> items;
+};
+
+//* Bytes inspected for a NUL when deciding whether a file is binary *//
+constexpr qint64 BinaryProbeSize = 8 * 1024;
+//* Matches collected by a worker before they are handed to the GUI thread *//
+constexpr int BatchSize = 256;
+constexpr qint64 BatchIntervalMs = 50;
+//* Longest line excerpt kept for the results list *//
+constexpr int PreviewBytes = 400;
+
+inline char asciiLower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? char(c + ('a' - 'A')) : c;
+}
+
+inline char asciiUpper(char c)
+{
+    return (c >= 'a' && c <= 'z') ? char(c - ('a' - 'A')) : c;
+}
+
+bool equalsIgnoreCase(const char *text, const QByteArray &lowerPattern)
+{
+    for (int i = 0; i < lowerPattern.size(); ++i)
+    {
+        if (asciiLower(text[i]) != lowerPattern[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool isAscii(const QByteArray &bytes)
+{
+    for (char c : bytes)
+    {
+        if (uchar(c) >= 0x80)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+struct SearchJob
+{
+    quint64 id = 0;
+    SearchOptions options;
+    QSet<QString> ignored;
+
+    //* Literal searches scan raw UTF-8, everything else goes through the regex *//
+    bool useRegex = false;
+    QByteArray literal;
+    QRegularExpression regex;
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::atomic<qint64> outstanding{0};
+    std::atomic<int> workersRunning{0};
+    std::atomic<bool> cancelled{false};
+    std::atomic<bool> truncated{false};
+    std::atomic<int> matchCount{0};
+    std::atomic<int> fileCount{0};
+};
+
+namespace {
+
+/*
+ * Per-thread state of one search worker. Everything except the shared SearchJob
+ * lives on the worker's own stack, so the hot loop takes no locks apart from
+ * the deque operations.
+ */
+class SearchWorker
+{
+public:
+    SearchWorker(const std::shared_ptr<SearchJob> &job, int index,
+                 std::function<void(QVector<SearchMatch>)> deliver)
+        : m_job(job), m_index(index), m_deliver(std::move(deliver))
+    {
+        m_sinceFlush.start();
+    }
+
+    void run();
+
+private:
+    bool takeWork(WorkItem &item);
+    void listDirectory(const QString &path);
+    void searchFile(const QString &path);
+    void searchLiteral(const QString &path, const char *data, qint64 size);
+    void searchRegex(const QString &path, const char *data, qint64 size);
+    bool addMatch(SearchMatch match);
+    void flush();
+
+    std::shared_ptr<SearchJob> m_job;
+    int m_index;
+    std::function<void(QVector<SearchMatch>)> m_deliver;
+    QVector<SearchMatch> m_batch;
+    QElapsedTimer m_sinceFlush;
+};
+
+void SearchWorker::run()
+{
+    SearchJob &job = *m_job;
+
+    while (!job.cancelled.load(std::memory_order_relaxed))
+    {
+        WorkItem item;
+        if (!takeWork(item))
+        {
+            //? Another worker may still be listing a directory that feeds us
+            if (job.outstanding.load() == 0)
+            {
+                break;
+            }
+            QThread::usleep(50);
+            continue;
+        }
+
+        if (item.isDirectory)
+        {
+            listDirectory(item.path);
+        }
+        else
+        {
+            searchFile(item.path);
+        }
+
+        //* Children were queued before this, so the count only hits zero when the walk is done *//
+        job.outstanding.fetch_sub(1);
+    }
+
+    flush();
+}
+
+bool SearchWorker::takeWork(WorkItem &item)
+{
+    SearchJob &job = *m_job;
+
+    //* Own deque is used as a stack, depth first keeps sibling files together *//
+    {
+        WorkQueue &own = *job.queues[m_index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.items.empty())
+        {
+            item = std::move(own.items.back());
+            own.items.pop_back();
+            return true;
+        }
+    }
+
+    //* Steal the oldest entry, which is the closest to the root and the largest piece of work *//
+    int count = int(job.queues.size());
+    for (int offset = 1; offset < count; ++offset)
+    {
+        WorkQueue &victim = *job.queues[(m_index + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.items.empty())
+        {
+            item = std::move(victim.items.front());
+            victim.items.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void SearchWorker::listDirectory(const QString &path)
+{
+    SearchJob &job = *m_job;
+    std::vector<WorkItem> children;
+
+    //? Symlinks are not followed, a link back up the tree would never terminate
+    QDirIterator it(path, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks);
+    while (it.hasNext())
+    {
+        it.next();
+        QFileInfo info = it.fileInfo();
+        if (job.ignored.contains(info.fileName()))
+        {
+            continue;
+        }
+
+        if (info.isDir())
+        {
+            children.push_back({info.filePath(), true});
+        }
+        else if (info.isFile() && info.size() > 0 && info.size() <= job.options.maxFileSize)
+        {
+            children.push_back({info.filePath(), false});
+        }
+    }
+
+    if (children.empty())
+    {
+        return;
+    }
+
+    job.outstanding.fetch_add(qint64(children.size()));
+    WorkQueue &own = *job.queues[m_index];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    for (WorkItem &child : children)
+    {
+        own.items.push_back(std::move(child));
+    }
+}
+
+void SearchWorker::searchFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+
+    qint64 size = file.size();
+    uchar *mapped = size > 0 ? file.map(0, size) : nullptr;
+    if (!mapped)
+    {
+        return;
+    }
+
+    const char *data = reinterpret_cast<const char *>(mapped);
+    if (!std::memchr(data, '\0', size_t(qMin(size, BinaryProbeSize))))
+    {
+        m_job->fileCount.fetch_add(1, std::memory_order_relaxed);
+        if (m_job->useRegex)
+        {
+            searchRegex(path, data, size);
+        }
+        else
+        {
+            searchLiteral(path, data, size);
+        }
+    }
+
+    file.unmap(mapped);
+
+    if (m_sinceFlush.elapsed() >= BatchIntervalMs)
+    {
+        flush();
+    }
+}
+
+/*
+ * memchr finds candidates for the first byte of the pattern (libc vectorizes
+ * it), memcmp or an ASCII case fold confirms them. Line numbers are counted
+ * lazily, only up to the next match.
+ */
+void SearchWorker::searchLiteral(const QString &path, const char *data, qint64 size)
+{
+    const QByteArray &pattern = m_job->literal;
+    const bool caseSensitive = m_job->options.caseSensitive;
+    const qint64 length = pattern.size();
+    const char *end = data + size;
+
+    const char lower = pattern[0];
+    const char upper = caseSensitive ? lower : asciiUpper(lower);
+
+    //* Offsets of the next occurrence of each case of the first byte, -1 once there are none left *//
+    qint64 pos = 0;
+    qint64 nextLower = -2;
+    qint64 nextUpper = lower == upper ? -1 : -2;
+    auto refresh = [&](qint64 &next, char c) {
+        if (next == -1 || next >= pos)
+        {
+            return;
+        }
+        const void *found = std::memchr(data + pos, c, size_t(size - pos));
+        next = found ? static_cast<const char *>(found) - data : -1;
+    };
+
+    int line = 0;
+    const char *lineStart = data;
+    const char *counted = data;
+
+    while (pos < size && !m_job->cancelled.load(std::memory_order_relaxed))
+    {
+        refresh(nextLower, lower);
+        refresh(nextUpper, upper);
+        if (nextLower < 0 && nextUpper < 0)
+        {
+            break;
+        }
+
+        qint64 offset = nextLower < 0 ? nextUpper : (nextUpper < 0 ? nextLower : qMin(nextLower, nextUpper));
+        const char *hit = data + offset;
+
+        bool matched = end - hit >= length
+                       && (caseSensitive ? std::memcmp(hit, pattern.constData(), size_t(length)) == 0
+                                         : equalsIgnoreCase(hit, pattern));
+        if (!matched)
+        {
+            pos = offset + 1;
+            continue;
+        }
+
+        while (const char *nl = static_cast<const char *>(std::memchr(counted, '\n', size_t(hit - counted))))
+        {
+            ++line;
+            lineStart = nl + 1;
+            counted = nl + 1;
+        }
+        counted = hit;
+
+        const char *lineEnd = static_cast<const char *>(std::memchr(hit, '\n', size_t(end - hit)));
+        if (!lineEnd)
+        {
+            lineEnd = end;
+        }
+        if (lineEnd > lineStart && *(lineEnd - 1) == '\r')
+        {
+            --lineEnd;
+        }
+
+        SearchMatch match;
+        match.filePath = path;
+        match.line = line;
+        match.column = QString::fromUtf8(lineStart, int(hit - lineStart)).size();
+        match.length = QString::fromUtf8(hit, int(length)).size();
+        match.preview = QString::fromUtf8(lineStart, int(qMin<qint64>(lineEnd - lineStart, PreviewBytes)));
+        if (!addMatch(std::move(match)))
+        {
+            return;
+        }
+
+        pos = offset + length;
+    }
+}
+
+void SearchWorker::searchRegex(const QString &path, const char *data, qint64 size)
+{
+    const QString text = QString::fromUtf8(data, int(qMin<qint64>(size, std::numeric_limits<int>::max())));
+
+    int line = 0;
+    qsizetype lineStart = 0;
+    qsizetype counted = 0;
+
+    QRegularExpressionMatchIterator it = m_job->regex.globalMatch(text);
+    while (it.hasNext() && !m_job->cancelled.load(std::memory_order_relaxed))
+    {
+        QRegularExpressionMatch found = it.next();
+        qsizetype start = found.capturedStart();
+        if (found.capturedLength() == 0)
+        {
+            continue;
+        }
+
+        for (qsizetype nl = text.indexOf(QLatin1Char('\n'), counted); nl >= 0 && nl < start;
+             nl = text.indexOf(QLatin1Char('\n'), nl + 1))
+        {
+            ++line;
+            lineStart = nl + 1;
+        }
+        counted = start;
+
+        qsizetype lineEnd = text.indexOf(QLatin1Char('\n'), start);
+        if (lineEnd < 0)
+        {
+            lineEnd = text.size();
+        }
+        if (lineEnd > lineStart && text.at(lineEnd - 1) == QLatin1Char('\r'))
+        {
+            --lineEnd;
+        }
+
+        SearchMatch match;
+        match.filePath = path;
+        match.line = line;
+        match.column = int(start - lineStart);
+        match.length = int(found.capturedLength());
+        match.preview = text.mid(lineStart, qMin<qsizetype>(lineEnd - lineStart, PreviewBytes));
+        if (!addMatch(std::move(match)))
+        {
+            return;
+        }
+    }
+}
+
+bool SearchWorker::addMatch(SearchMatch match)
+{
+    SearchJob &job = *m_job;
+
+    //* The cap is shared by all workers, the first one past it stops the search *//
+    if (job.matchCount.fetch_add(1) >= job.options.maxResults)
+    {
+        job.matchCount.fetch_sub(1);
+        job.truncated.store(true);
+        job.cancelled.store(true);
+        return false;
+    }
+
+    m_batch.append(std::move(match));
+    if (m_batch.size() >= BatchSize)
+    {
+        flush();
+    }
+    return true;
+}
+
+void SearchWorker::flush()
+{
+    if (!m_batch.isEmpty())
+    {
+        m_deliver(std::move(m_batch));
+        m_batch = QVector<SearchMatch>();
+        m_batch.reserve(BatchSize);
+    }
+    m_sinceFlush.restart();
+}
+
+}
+
+QStringList SearchOptions::defaultIgnoredNames()
+{
+    return {".git", ".hg", ".svn", "node_modules", "bower_components", ".cache", ".idea", ".vs",
+            "__pycache__", ".DS_Store"};
+}
+
+ProjectSearch::ProjectSearch(QObject *parent)
+    : QObject(parent), m_jobCounter(0)
+{
+}
+
+ProjectSearch::~ProjectSearch()
+{
+    stopWorkers();
+}
+
+void ProjectSearch::start(const QString &rootPath, const SearchOptions &options)
+{
+    stopWorkers();
+
+    if (options.pattern.isEmpty() || rootPath.isEmpty())
+    {
+        return;
+    }
+
+    auto job = std::make_shared<SearchJob>();
+    job->id = ++m_jobCounter;
+    job->options = options;
+    for (const QString &name : options.ignoredNames)
+    {
+        job->ignored.insert(name);
+    }
+
+    //? Case folding beyond ASCII needs Unicode tables, leave that to the regex engine
+    QByteArray utf8 = options.pattern.toUtf8();
+    job->useRegex = options.regularExpression || (!options.caseSensitive && !isAscii(utf8));
+    if (job->useRegex)
+    {
+        QString pattern = options.regularExpression ? options.pattern
+                                                    : QRegularExpression::escape(options.pattern);
+        QRegularExpression::PatternOptions patternOptions = QRegularExpression::MultilineOption;
+        if (!options.caseSensitive)
+        {
+            patternOptions |= QRegularExpression::CaseInsensitiveOption;
+        }
+        job->regex = QRegularExpression(pattern, patternOptions);
+        if (!job->regex.isValid())
+        {
+            VOLT_WARN_F("ProjectSearch: invalid pattern %1", job->regex.errorString());
+            emit finished(0, 0, false);
+            return;
+        }
+        job->regex.optimize();
+    }
+    else
+    {
+        job->literal = options.caseSensitive ? utf8 : utf8.toLower();
+    }
+
+    int workerCount = qMax(2, QThread::idealThreadCount());
+    for (int i = 0; i < workerCount; ++i)
+    {
+        job->queues.push_back(std::make_unique<WorkQueue>());
+    }
+    if (options.restrictToFiles)
+    {
+        //* Dealt round robin, stealing evens out whatever imbalance is left *//
+        for (int i = 0; i < options.files.size(); ++i)
+        {
+            job->queues[size_t(i % workerCount)]->items.push_back({options.files.at(i), false});
+        }
+        job->outstanding.store(options.files.size());
+    }
+    else
+    {
+        job->queues[0]->items.push_back({rootPath, true});
+        job->outstanding.store(1);
+    }
+    job->workersRunning.store(workerCount);
+
+    m_job = job;
+    VOLT_DEBUG_F2("ProjectSearch: searching %1 with %2 workers", rootPath, QString::number(workerCount));
+
+    for (int i = 0; i < workerCount; ++i)
+    {
+        m_workers.emplace_back([this, job, i]() {
+            quint64 id = job->id;
+            SearchWorker worker(job, i, [this, id](QVector<SearchMatch> matches) {
+                QMetaObject::invokeMethod(this, [this, id, matches]() { deliver(id, matches); },
+                                          Qt::QueuedConnection);
+            });
+            worker.run();
+
+            if (job->workersRunning.fetch_sub(1) == 1)
+            {
+                QMetaObject::invokeMethod(this, [this, id]() { complete(id); }, Qt::QueuedConnection);
+            }
+        });
+    }
+}
+
+void ProjectSearch::cancel()
+{
+    if (!m_job)
+    {
+        return;
+    }
+
+    int matchCount = m_job->matchCount.load();
+    int fileCount = m_job->fileCount.load();
+    stopWorkers();
+    emit finished(matchCount, fileCount, false);
+}
+
+void ProjectSearch::stopWorkers()
+{
+    if (m_job)
+    {
+        m_job->cancelled.store(true);
+    }
+    for (std::thread &worker : m_workers)
+    {
+        worker.join();
+    }
+    m_workers.clear();
+
+    //* Batches still queued for the GUI thread carry the old id and are dropped *//
+    m_job.reset();
+}
+
+void ProjectSearch::deliver(quint64 jobId, const QVector<SearchMatch> &matches)
+{
+    if (!m_job || m_job->id != jobId)
+    {
+        return;
+    }
+    emit matchesFound(matches);
+}
+
+void ProjectSearch::complete(quint64 jobId)
+{
+    if (!m_job || m_job->id != jobId)
+    {
+        return;
+    }
+
+    int matchCount = m_job->matchCount.load();
+    int fileCount = m_job->fileCount.load();
+    bool truncated = m_job->truncated.load();
+    stopWorkers();
+
+    VOLT_DEBUG_F2("ProjectSearch: %1 matches in %2 files", QString::number(matchCount), QString::number(fileCount));
+    emit finished(matchCount, fileCount, truncated);
+}
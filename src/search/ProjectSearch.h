@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <memory>
+#include <thread>
+#include <vector>
+
+struct SearchJob;
+
+struct SearchMatch
+{
+    QString filePath;
+    int line = 0;   // zero-based
+    int column = 0; // UTF-16 offset of the match within its line
+    int length = 0; // UTF-16 length of the match
+    QString preview;
+};
+
+struct SearchOptions
+{
+    QString pattern;
+    bool regularExpression = false;
+    bool caseSensitive = false;
+    int maxResults = 20000;
+    qint64 maxFileSize = 32LL * 1024 * 1024;
+    // File and directory names that are never descended into or searched
+    QStringList ignoredNames = defaultIgnoredNames();
+    // Search only these files instead of walking the tree, e.g. candidates from the trigram index
+    bool restrictToFiles = false;
+    QStringList files;
+
+    static QStringList defaultIgnoredNames();
+};
+
+/*
+ * Find in files across a project tree.
+ *
+ * One worker per core walks the tree with its own deque of directories and
+ * files. A worker pops from the back of its own deque and, once that is empty,
+ * steals from the front of another worker's deque, so a single huge
+ * subdirectory still ends up spread over every core. Files are memory-mapped
+ * and scanned in place; binaries (a NUL byte in the first 8 KB) are skipped.
+ *
+ * Matches are delivered in batches through matchesFound() while the search is
+ * still running. Starting a new search or calling cancel() stops the current
+ * one, and nothing from a stopped search is delivered afterwards.
+ */
+class ProjectSearch : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ProjectSearch(QObject *parent = nullptr);
+    ~ProjectSearch();
+
+    void start(const QString &rootPath, const SearchOptions &options);
+    void cancel();
+    bool isRunning() const { return m_job != nullptr; }
+
+signals:
+    void matchesFound(const QVector<SearchMatch> &matches);
+    void finished(int matchCount, int fileCount, bool truncated);
+
+private:
+    void deliver(quint64 jobId, const QVector<SearchMatch> &matches);
+    void complete(quint64 jobId);
+    void stopWorkers();
+
+    std::shared_ptr<SearchJob> m_job;
+    std::vector<std::thread> m_workers;
+    quint64 m_jobCounter;
+};
@@ -0,0 +1,867 @@
+#include "TrigramIndex.h"
+#include "ProjectSearch.h"
+#include "../logging/VoltLogger.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QSet>
+#include <QStandardPaths>
+#include <QThread>
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr char IndexMagic[8] = {'V', 'O', 'L', 'T', 'T', 'R', 'I', '\0'};
+constexpr quint32 IndexVersion = 1;
+//* Written natively, a file from a machine with the other byte order fails this check *//
+constexpr quint32 IndexByteOrder = 0x01020304;
+constexpr qint64 BinaryProbeSize = 8 * 1024;
+
+struct IndexHeader
+{
+    char magic[8];
+    quint32 version;
+    quint32 byteOrder;
+    quint32 fileCount;
+    quint32 trigramCount;
+    quint64 filesOffset;
+    quint64 pathsOffset;
+    quint64 trigramsOffset;
+    quint64 postingsOffset;
+    quint64 fileSize;
+};
+
+struct IndexFileEntry
+{
+    quint64 pathOffset;
+    quint32 pathLength;
+    quint32 reserved;
+    qint64 modified;
+    qint64 size;
+};
+
+struct IndexTrigramEntry
+{
+    quint32 trigram;
+    quint32 count;
+    quint64 postingsOffset;
+};
+
+struct WalkedFile
+{
+    QByteArray relativePath;
+    qint64 modified;
+    qint64 size;
+};
+
+inline uchar asciiLower(uchar c)
+{
+    return (c >= 'A' && c <= 'Z') ? uchar(c + ('a' - 'A')) : c;
+}
+
+inline quint32 trigramAt(const uchar *p)
+{
+    return (quint32(asciiLower(p[0])) << 16) | (quint32(asciiLower(p[1])) << 8) | quint32(asciiLower(p[2]));
+}
+
+//* Literal searches are single-line, so trigrams spanning a line break are never looked up *//
+inline bool spansLine(const uchar *p)
+{
+    return p[0] == '\n' || p[1] == '\n' || p[2] == '\n';
+}
+
+void appendVarint(std::string &out, quint32 value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(char(value));
+}
+
+void decodePostings(const uchar *p, const uchar *end, std::vector<quint32> &ids)
+{
+    quint32 previous = 0;
+    while (p < end)
+    {
+        quint32 value = 0;
+        int shift = 0;
+        while (p < end)
+        {
+            uchar byte = *p++;
+            value |= quint32(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+            {
+                break;
+            }
+            shift += 7;
+        }
+        previous += value;
+        ids.push_back(previous);
+    }
+}
+
+/*
+ * Posting lists of one builder thread. Ids arrive in increasing order per
+ * thread, so they can be delta-encoded right away and stay compact.
+ */
+struct PostingList
+{
+    std::string bytes;
+    quint32 last = 0;
+    quint32 count = 0;
+
+    void add(quint32 id)
+    {
+        appendVarint(bytes, count == 0 ? id : id - last);
+        last = id;
+        ++count;
+    }
+};
+
+using PostingMap = std::unordered_map<quint32, PostingList>;
+
+/*
+ * Breadth first, so when the watcher cap is hit it is the deep directories
+ * that go unwatched.
+ */
+bool walkTree(const QString &root, const QSet<QString> &ignored, qint64 maxFileSize,
+              const std::atomic<bool> &cancelled, std::vector<WalkedFile> &files, QStringList &directories)
+{
+    std::deque<QString> pending{root};
+    const int prefix = root.size() + 1;
+
+    while (!pending.empty())
+    {
+        if (cancelled.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+
+        QString dir = std::move(pending.front());
+        pending.pop_front();
+        directories.append(dir);
+
+        QDirIterator it(dir, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks);
+        while (it.hasNext())
+        {
+            it.next();
+            QFileInfo info = it.fileInfo();
+            if (ignored.contains(info.fileName()))
+            {
+                continue;
+            }
+
+            if (info.isDir())
+            {
+                pending.push_back(info.filePath());
+            }
+            else if (info.isFile() && info.size() > 0 && info.size() <= maxFileSize)
+            {
+                files.push_back({info.filePath().mid(prefix).toUtf8(),
+                                 info.lastModified().toMSecsSinceEpoch(), info.size()});
+            }
+        }
+    }
+    return true;
+}
+
+/*
+ * Walks directories that reported a change. Subdirectories in watched report
+ * their own changes and are not entered; new ones are walked as well, at
+ * most budget of them, and returned in added so they get watched.
+ */
+bool walkChanged(const QStringList &changedDirectories, const QString &root, const QSet<QString> &watched,
+                 int budget, const QSet<QString> &ignored, qint64 maxFileSize, const std::atomic<bool> &cancelled,
+                 std::vector<WalkedFile> &files, QStringList &added)
+{
+    std::deque<QString> pending(changedDirectories.begin(), changedDirectories.end());
+    const int prefix = root.size() + 1;
+
+    while (!pending.empty())
+    {
+        if (cancelled.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+
+        QString dir = std::move(pending.front());
+        pending.pop_front();
+
+        QDirIterator it(dir, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks);
+        while (it.hasNext())
+        {
+            it.next();
+            QFileInfo info = it.fileInfo();
+            if (ignored.contains(info.fileName()))
+            {
+                continue;
+            }
+
+            if (info.isDir())
+            {
+                if (!watched.contains(info.filePath()) && added.size() < budget)
+                {
+                    added.append(info.filePath());
+                    pending.push_back(info.filePath());
+                }
+            }
+            else if (info.isFile() && info.size() > 0 && info.size() <= maxFileSize)
+            {
+                files.push_back({info.filePath().mid(prefix).toUtf8(),
+                                 info.lastModified().toMSecsSinceEpoch(), info.size()});
+            }
+        }
+    }
+    return true;
+}
+
+/*
+ * Collects the distinct trigrams of one file into postings. The bitmap has
+ * one bit per possible trigram (2 MB) and is cleared through the list of
+ * trigrams that were set, so the cost stays proportional to the file.
+ */
+void indexFile(const QString &path, quint32 id, std::vector<quint64> &bitmap, std::vector<quint32> &seen,
+               PostingMap &postings)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+
+    qint64 size = file.size();
+    uchar *data = size >= 3 ? file.map(0, size) : nullptr;
+    if (!data)
+    {
+        return;
+    }
+
+    if (!std::memchr(data, '\0', size_t(qMin(size, BinaryProbeSize))))
+    {
+        const uchar *end = data + size - 2;
+        for (const uchar *p = data; p < end; ++p)
+        {
+            if (spansLine(p))
+            {
+                continue;
+            }
+            quint32 t = trigramAt(p);
+            quint64 bit = quint64(1) << (t & 63);
+            if (!(bitmap[t >> 6] & bit))
+            {
+                bitmap[t >> 6] |= bit;
+                seen.push_back(t);
+            }
+        }
+
+        for (quint32 t : seen)
+        {
+            postings[t].add(id);
+            bitmap[t >> 6] = 0;
+        }
+        seen.clear();
+    }
+
+    file.unmap(data);
+}
+
+bool writeIndex(const QString &path, const std::vector<WalkedFile> &files, std::vector<PostingMap> &shards,
+                const std::atomic<bool> &cancelled)
+{
+    QFile out(path);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        VOLT_WARN_F("TrigramIndex: cannot write %1", path);
+        return false;
+    }
+
+    std::vector<quint32> trigrams;
+    for (const PostingMap &shard : shards)
+    {
+        for (const auto &entry : shard)
+        {
+            trigrams.push_back(entry.first);
+        }
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+    IndexHeader header;
+    std::memcpy(header.magic, IndexMagic, sizeof(IndexMagic));
+    header.version = IndexVersion;
+    header.byteOrder = IndexByteOrder;
+    header.fileCount = quint32(files.size());
+    header.trigramCount = quint32(trigrams.size());
+    header.filesOffset = sizeof(IndexHeader);
+    header.pathsOffset = header.filesOffset + files.size() * sizeof(IndexFileEntry);
+
+    //* File table and paths *//
+    QByteArray table;
+    QByteArray paths;
+    table.reserve(int(files.size() * sizeof(IndexFileEntry)));
+    for (const WalkedFile &file : files)
+    {
+        IndexFileEntry entry;
+        entry.pathOffset = header.pathsOffset + quint64(paths.size());
+        entry.pathLength = quint32(file.relativePath.size());
+        entry.reserved = 0;
+        entry.modified = file.modified;
+        entry.size = file.size;
+        table.append(reinterpret_cast<const char *>(&entry), sizeof(entry));
+        paths.append(file.relativePath);
+    }
+
+    header.trigramsOffset = (header.pathsOffset + quint64(paths.size()) + 7) & ~quint64(7);
+    header.postingsOffset = header.trigramsOffset + trigrams.size() * sizeof(IndexTrigramEntry);
+
+    out.seek(header.filesOffset);
+    out.write(table);
+    out.write(paths);
+
+    //* Postings are merged per trigram and streamed out, the trigram table is written last *//
+    std::vector<IndexTrigramEntry> entries;
+    entries.reserve(trigrams.size());
+    out.seek(header.postingsOffset);
+    quint64 offset = header.postingsOffset;
+
+    std::vector<quint32> ids;
+    std::string encoded;
+    for (quint32 trigram : trigrams)
+    {
+        if (cancelled.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+
+        ids.clear();
+        for (PostingMap &shard : shards)
+        {
+            auto it = shard.find(trigram);
+            if (it != shard.end())
+            {
+                const std::string &bytes = it->second.bytes;
+                decodePostings(reinterpret_cast<const uchar *>(bytes.data()),
+                               reinterpret_cast<const uchar *>(bytes.data() + bytes.size()), ids);
+                shard.erase(it);
+            }
+        }
+        std::sort(ids.begin(), ids.end());
+
+        encoded.clear();
+        quint32 previous = 0;
+        for (quint32 id : ids)
+        {
+            appendVarint(encoded, id - previous);
+            previous = id;
+        }
+
+        entries.push_back({trigram, quint32(ids.size()), offset});
+        out.write(encoded.data(), qint64(encoded.size()));
+        offset += encoded.size();
+    }
+
+    header.fileSize = offset;
+    out.resize(qint64(offset));
+    out.seek(header.trigramsOffset);
+    out.write(reinterpret_cast<const char *>(entries.data()), qint64(entries.size() * sizeof(IndexTrigramEntry)));
+    out.seek(0);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    return out.error() == QFile::NoError;
+}
+
+}
+
+TrigramIndex::TrigramIndex(QObject *parent)
+    : QObject(parent), m_data(nullptr), m_size(0), m_dirtyStamp(0), m_taskDirtyStamp(0),
+      m_cancelled(false), m_generation(0)
+{
+    m_rebuildTimer.setSingleShot(true);
+    m_rebuildTimer.setInterval(30000);
+
+    connect(&m_rebuildTimer, &QTimer::timeout, this, &TrigramIndex::rebuild);
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &TrigramIndex::onDirectoryChanged);
+}
+
+TrigramIndex::~TrigramIndex()
+{
+    stopTask();
+    unmapIndex();
+}
+
+void TrigramIndex::setRootPath(const QString &rootPath)
+{
+    if (rootPath == m_rootPath)
+    {
+        return;
+    }
+
+    stopTask();
+    unmapIndex();
+    m_dirty.clear();
+    m_pendingRescan.clear();
+    m_rebuildTimer.stop();
+    unwatchAll();
+
+    m_rootPath = rootPath;
+    if (m_rootPath.isEmpty())
+    {
+        return;
+    }
+
+    //* A saved index answers right away, the refresh only collects what changed since *//
+    if (mapIndex())
+    {
+        VOLT_INFO_F("TrigramIndex: loaded %1", indexPath());
+        emit indexReady();
+        startTask(Task::Refresh);
+    }
+    else
+    {
+        startTask(Task::Build);
+    }
+}
+
+QString TrigramIndex::indexPath() const
+{
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/search-index";
+    QByteArray key = QCryptographicHash::hash(m_rootPath.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return dir + "/" + QString::fromLatin1(key) + ".idx";
+}
+
+bool TrigramIndex::mapIndex()
+{
+    m_file.setFileName(indexPath());
+    if (!m_file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    m_size = m_file.size();
+    if (m_size >= qint64(sizeof(IndexHeader)))
+    {
+        m_data = m_file.map(0, m_size);
+    }
+
+    const IndexHeader *header = reinterpret_cast<const IndexHeader *>(m_data);
+    if (!m_data || std::memcmp(header->magic, IndexMagic, sizeof(IndexMagic)) != 0
+        || header->version != IndexVersion || header->byteOrder != IndexByteOrder
+        || header->fileSize != quint64(m_size))
+    {
+        VOLT_DEBUG_F("TrigramIndex: ignoring unusable index %1", indexPath());
+        unmapIndex();
+        return false;
+    }
+    return true;
+}
+
+void TrigramIndex::unmapIndex()
+{
+    if (m_data)
+    {
+        m_file.unmap(const_cast<uchar *>(m_data));
+        m_data = nullptr;
+    }
+    if (m_file.isOpen())
+    {
+        m_file.close();
+    }
+    m_size = 0;
+}
+
+int TrigramIndex::findFile(const QByteArray &relativePath) const
+{
+    if (!m_data)
+    {
+        return -1;
+    }
+
+    const IndexHeader *header = reinterpret_cast<const IndexHeader *>(m_data);
+    const IndexFileEntry *entries = reinterpret_cast<const IndexFileEntry *>(m_data + header->filesOffset);
+
+    //* Same ordering as QByteArray::operator<, which the builder sorted with *//
+    auto less = [this, &relativePath](const IndexFileEntry &entry) {
+        int length = int(qMin<quint32>(entry.pathLength, quint32(relativePath.size())));
+        int cmp = std::memcmp(m_data + entry.pathOffset, relativePath.constData(), size_t(length));
+        return cmp < 0 || (cmp == 0 && entry.pathLength < quint32(relativePath.size()));
+    };
+
+    int low = 0;
+    int high = int(header->fileCount);
+    while (low < high)
+    {
+        int mid = (low + high) / 2;
+        if (less(entries[mid]))
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    if (low < int(header->fileCount) && entries[low].pathLength == quint32(relativePath.size())
+        && std::memcmp(m_data + entries[low].pathOffset, relativePath.constData(), size_t(relativePath.size())) == 0)
+    {
+        return low;
+    }
+    return -1;
+}
+
+bool TrigramIndex::candidates(const QString &literal, bool caseSensitive, QStringList &files) const
+{
+    QByteArray pattern = literal.toUtf8();
+    if (!m_data || pattern.size() < 3)
+    {
+        return false;
+    }
+
+    //? The index folds ASCII only, other scripts would need Unicode case folding
+    if (!caseSensitive)
+    {
+        for (char c : pattern)
+        {
+            if (uchar(c) >= 0x80)
+            {
+                return false;
+            }
+        }
+    }
+
+    const IndexHeader *header = reinterpret_cast<const IndexHeader *>(m_data);
+    const IndexTrigramEntry *table = reinterpret_cast<const IndexTrigramEntry *>(m_data + header->trigramsOffset);
+    const IndexTrigramEntry *tableEnd = table + header->trigramCount;
+
+    std::vector<const IndexTrigramEntry *> lookups;
+    bool missing = false;
+    const uchar *bytes = reinterpret_cast<const uchar *>(pattern.constData());
+    for (int i = 0; i + 2 < pattern.size() && !missing; ++i)
+    {
+        quint32 t = trigramAt(bytes + i);
+        const IndexTrigramEntry *entry = std::lower_bound(table, tableEnd, t,
+            [](const IndexTrigramEntry &e, quint32 value) { return e.trigram < value; });
+        if (entry == tableEnd || entry->trigram != t)
+        {
+            missing = true;
+        }
+        else if (std::find(lookups.begin(), lookups.end(), entry) == lookups.end())
+        {
+            lookups.push_back(entry);
+        }
+    }
+
+    //* Intersect starting from the rarest trigram so the working set only shrinks *//
+    std::vector<quint32> ids;
+    if (!missing)
+    {
+        std::sort(lookups.begin(), lookups.end(),
+                  [](const IndexTrigramEntry *a, const IndexTrigramEntry *b) { return a->count < b->count; });
+
+        std::vector<quint32> next;
+        std::vector<quint32> merged;
+        for (size_t i = 0; i < lookups.size(); ++i)
+        {
+            const IndexTrigramEntry *entry = lookups[i];
+            quint64 end = entry + 1 < tableEnd ? (entry + 1)->postingsOffset : header->fileSize;
+            std::vector<quint32> &target = i == 0 ? ids : next;
+            target.clear();
+            decodePostings(m_data + entry->postingsOffset, m_data + end, target);
+
+            if (i > 0)
+            {
+                merged.clear();
+                std::set_intersection(ids.begin(), ids.end(), next.begin(), next.end(), std::back_inserter(merged));
+                ids.swap(merged);
+            }
+            if (ids.empty())
+            {
+                break;
+            }
+        }
+    }
+
+    const IndexFileEntry *entries = reinterpret_cast<const IndexFileEntry *>(m_data + header->filesOffset);
+    const QString prefix = m_rootPath + QLatin1Char('/');
+    files.clear();
+    files.reserve(int(ids.size()) + m_dirty.size());
+    for (quint32 id : ids)
+    {
+        const IndexFileEntry &entry = entries[id];
+        files.append(prefix + QString::fromUtf8(reinterpret_cast<const char *>(m_data + entry.pathOffset),
+                                                int(entry.pathLength)));
+    }
+
+    //* Changed files are verified by the scan regardless of what the index says *//
+    for (auto it = m_dirty.constBegin(); it != m_dirty.constEnd(); ++it)
+    {
+        int id = findFile(it.key().mid(prefix.size()).toUtf8());
+        if (id < 0 || !std::binary_search(ids.begin(), ids.end(), quint32(id)))
+        {
+            files.append(it.key());
+        }
+    }
+
+    return true;
+}
+
+void TrigramIndex::markDirty(const QString &filePath)
+{
+    if (!m_rootPath.isEmpty() && filePath.startsWith(m_rootPath + QLatin1Char('/')))
+    {
+        addDirty(filePath);
+    }
+}
+
+void TrigramIndex::addDirty(const QString &filePath)
+{
+    m_dirty.insert(filePath, ++m_dirtyStamp);
+
+    //* Rebuild once things settle, or soon if the overlay is already large *//
+    m_rebuildTimer.start(m_dirty.size() >= RebuildThreshold ? 2000 : 30000);
+}
+
+/*
+ * A directory's entries changed. The directory is queued for a rescan on the
+ * worker, which compares its files with the index like the refresh pass and
+ * walks directories that appeared. A running task picks the queue up when it
+ * finishes.
+ */
+void TrigramIndex::onDirectoryChanged(const QString &path)
+{
+    if (m_rootPath.isEmpty() || !path.startsWith(m_rootPath))
+    {
+        return;
+    }
+
+    //? The watcher drops a deleted directory by itself, forget it so a new one at that path is watched again
+    if (!QFileInfo::exists(path))
+    {
+        m_watched.remove(path);
+        return;
+    }
+
+    m_pendingRescan.insert(path);
+    if (!m_worker.joinable())
+    {
+        startTask(Task::Rescan);
+    }
+}
+
+void TrigramIndex::watch(const QString &directory)
+{
+    if (m_watched.size() < MaxWatchedDirectories && !m_watched.contains(directory)
+        && m_watcher.addPath(directory))
+    {
+        m_watched.insert(directory);
+    }
+}
+
+void TrigramIndex::unwatchAll()
+{
+    if (!m_watcher.directories().isEmpty())
+    {
+        m_watcher.removePaths(m_watcher.directories());
+    }
+    m_watched.clear();
+}
+
+void TrigramIndex::rebuild()
+{
+    if (m_rootPath.isEmpty())
+    {
+        return;
+    }
+
+    //* Let a running refresh finish, its results feed the rebuild decision anyway *//
+    if (m_worker.joinable())
+    {
+        m_rebuildTimer.start(2000);
+        return;
+    }
+    startTask(Task::Build);
+}
+
+void TrigramIndex::startTask(Task task)
+{
+    stopTask();
+
+    quint64 generation = m_generation;
+    QString root = m_rootPath;
+    QString target = indexPath() + ".tmp";
+    QDir().mkpath(QFileInfo(target).absolutePath());
+    m_taskDirtyStamp = m_dirtyStamp;
+
+    //* Build and refresh walk the whole tree, so queued rescans are covered by any task *//
+    const QStringList rescan = task == Task::Rescan ? m_pendingRescan.values() : QStringList();
+    m_pendingRescan.clear();
+    const QSet<QString> watched = m_watched;
+    const int budget = MaxWatchedDirectories - int(m_watched.size());
+
+    m_worker = std::thread([this, task, generation, root, target, rescan, watched, budget]() {
+        QElapsedTimer timer;
+        timer.start();
+
+        SearchOptions defaults;
+        const QSet<QString> ignored(defaults.ignoredNames.begin(), defaults.ignoredNames.end());
+
+        std::vector<WalkedFile> files;
+        QStringList directories;
+        QStringList changed;
+        bool ok = task == Task::Rescan
+                      ? walkChanged(rescan, root, watched, budget, ignored, defaults.maxFileSize, m_cancelled,
+                                    files, directories)
+                      : walkTree(root, ignored, defaults.maxFileSize, m_cancelled, files, directories);
+
+        if (ok && task != Task::Build)
+        {
+            //* Only stats are compared, nothing is read; without an index every file counts as changed *//
+            const IndexFileEntry *entries = m_data
+                ? reinterpret_cast<const IndexFileEntry *>(m_data + reinterpret_cast<const IndexHeader *>(m_data)->filesOffset)
+                : nullptr;
+            for (const WalkedFile &file : files)
+            {
+                int id = findFile(file.relativePath);
+                if (id < 0 || entries[id].size != file.size || entries[id].modified != file.modified)
+                {
+                    changed.append(root + QLatin1Char('/') + QString::fromUtf8(file.relativePath));
+                }
+            }
+        }
+        else if (ok)
+        {
+            std::sort(files.begin(), files.end(),
+                      [](const WalkedFile &a, const WalkedFile &b) { return a.relativePath < b.relativePath; });
+
+            int threadCount = qMax(1, QThread::idealThreadCount());
+            std::vector<PostingMap> shards(size_t(threadCount));
+            std::atomic<size_t> next{0};
+
+            auto work = [&](int shard) {
+                std::vector<quint64> bitmap(size_t(1) << 18, 0);
+                std::vector<quint32> seen;
+                for (size_t i = next.fetch_add(1); i < files.size() && !m_cancelled.load(std::memory_order_relaxed);
+                     i = next.fetch_add(1))
+                {
+                    indexFile(root + QLatin1Char('/') + QString::fromUtf8(files[i].relativePath), quint32(i),
+                              bitmap, seen, shards[size_t(shard)]);
+                }
+            };
+
+            std::vector<std::thread> helpers;
+            for (int i = 1; i < threadCount; ++i)
+            {
+                helpers.emplace_back(work, i);
+            }
+            work(0);
+            for (std::thread &helper : helpers)
+            {
+                helper.join();
+            }
+
+            ok = !m_cancelled.load() && writeIndex(target, files, shards, m_cancelled);
+        }
+
+        if (ok && task != Task::Rescan)
+        {
+            VOLT_INFO_F2("TrigramIndex: %1 took %2 ms",
+                         QString("%1 of %2 files").arg(task == Task::Build ? "build" : "refresh").arg(files.size()),
+                         QString::number(timer.elapsed()));
+        }
+        else if (task == Task::Build)
+        {
+            QFile::remove(target);
+        }
+
+        if (!ok)
+        {
+            changed.clear();
+            directories.clear();
+        }
+        QMetaObject::invokeMethod(this, [this, generation, task, ok, changed, directories]() {
+            onTaskFinished(generation, ok ? task : Task::Refresh, changed, directories);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void TrigramIndex::stopTask()
+{
+    m_cancelled.store(true);
+    if (m_worker.joinable())
+    {
+        m_worker.join();
+    }
+    m_cancelled.store(false);
+
+    //* Whatever the stopped task already queued is ignored *//
+    ++m_generation;
+}
+
+void TrigramIndex::onTaskFinished(quint64 generation, Task task, const QStringList &changed,
+                                  const QStringList &directories)
+{
+    if (generation != m_generation)
+    {
+        return;
+    }
+    if (m_worker.joinable())
+    {
+        m_worker.join();
+    }
+
+    if (task == Task::Build && !directories.isEmpty())
+    {
+        QString target = indexPath();
+        unmapIndex();
+        QFile::remove(target);
+        if (!QFile::rename(target + ".tmp", target) || !mapIndex())
+        {
+            VOLT_WARN_F("TrigramIndex: could not install %1", target);
+            return;
+        }
+
+        //* Changes made while the build was reading the tree stay in the overlay *//
+        for (auto it = m_dirty.begin(); it != m_dirty.end();)
+        {
+            it = it.value() <= m_taskDirtyStamp ? m_dirty.erase(it) : std::next(it);
+        }
+        emit indexReady();
+    }
+
+    for (const QString &path : changed)
+    {
+        addDirty(path);
+    }
+
+    //* A rescan reports the directories that appeared, the full walks every directory of the tree *//
+    if (task != Task::Rescan && !directories.isEmpty())
+    {
+        unwatchAll();
+    }
+    for (const QString &directory : directories)
+    {
+        watch(directory);
+    }
+
+    if (m_dirty.size() >= RebuildThreshold)
+    {
+        m_rebuildTimer.start(0);
+    }
+
+    if (!m_pendingRescan.isEmpty())
+    {
+        startTask(Task::Rescan);
+    }
+}
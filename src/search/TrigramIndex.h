@@ -0,0 +1,108 @@
+#pragma once
+
+#include <QObject>
+#include <QFile>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <atomic>
+#include <thread>
+
+/*
+ * On-disk trigram index of a project tree, used to narrow find-in-files down
+ * to the files that can possibly contain a literal.
+ *
+ * Every file is reduced to the set of ASCII-lowercased byte trigrams it
+ * contains. The index maps each trigram to the sorted ids of the files that
+ * contain it, so the candidates for a pattern are the intersection of the
+ * posting lists of the pattern's trigrams. The index is a single file under
+ * the cache directory that is memory-mapped for lookups:
+ *
+ *   IndexHeader
+ *   IndexFileEntry[fileCount]       sorted by relative path
+ *   relative paths                  UTF-8, not terminated
+ *   IndexTrigramEntry[trigramCount] sorted by trigram
+ *   postings                        delta-encoded varints of file ids
+ *
+ * Building and refreshing run on a background thread. Files that changed
+ * since the index was written, reported by a QFileSystemWatcher, by a stat
+ * pass after loading, or by markDirty(), are kept in an overlay and always
+ * returned as candidates. Once the overlay grows large the index is rebuilt.
+ */
+class TrigramIndex : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TrigramIndex(QObject *parent = nullptr);
+    ~TrigramIndex();
+
+    void setRootPath(const QString &rootPath);
+    QString rootPath() const { return m_rootPath; }
+
+    bool isReady() const { return m_data != nullptr; }
+
+    /*
+     * Files that may contain the literal, as absolute paths. Returns false when
+     * the index cannot answer (not built yet, pattern shorter than a trigram,
+     * or a case-insensitive non-ASCII pattern), the caller then scans the tree.
+     */
+    bool candidates(const QString &literal, bool caseSensitive, QStringList &files) const;
+
+    // Reports a file whose content changed, e.g. after it was saved in the editor
+    void markDirty(const QString &filePath);
+
+    //* Overlay size that triggers a rebuild *//
+    static constexpr int RebuildThreshold = 512;
+    //* Directories watched for changes, the rest are picked up by the next refresh *//
+    static constexpr int MaxWatchedDirectories = 4096;
+
+signals:
+    void indexReady();
+
+private slots:
+    void onDirectoryChanged(const QString &path);
+    void rebuild();
+
+private:
+    enum class Task
+    {
+        Build,
+        Refresh,
+        // Compares the files of changed directories with the index
+        Rescan
+    };
+
+    void startTask(Task task);
+    void stopTask();
+    void onTaskFinished(quint64 generation, Task task, const QStringList &changed, const QStringList &directories);
+    bool mapIndex();
+    void unmapIndex();
+    QString indexPath() const;
+    int findFile(const QByteArray &relativePath) const;
+    void addDirty(const QString &filePath);
+    void watch(const QString &directory);
+    void unwatchAll();
+
+    QString m_rootPath;
+    QFile m_file;
+    const uchar *m_data;
+    qint64 m_size;
+
+    //* Absolute path -> stamp of the change, stamps older than a finished build are dropped *//
+    QHash<QString, quint64> m_dirty;
+    quint64 m_dirtyStamp;
+    quint64 m_taskDirtyStamp;
+
+    QFileSystemWatcher m_watcher;
+    //* Mirrors the watcher's directories, which it only hands out as a fresh list *//
+    QSet<QString> m_watched;
+    QSet<QString> m_pendingRescan;
+    QTimer m_rebuildTimer;
+
+    std::thread m_worker;
+    std::atomic<bool> m_cancelled;
+    quint64 m_generation;
+};
@@ -35,6 +35,32 @@ QString StyleHelper::getTreeViewStyle(const QColor &bgColor, const QColor &fgCol
         .arg(primaryColor.name());
 }
 
+QString StyleHelper::getSearchPanelStyle(const QColor &bgColor, const QColor &fgColor,
+                                         const QColor &selectionBg, const QColor &selectionFg,
+                                         const QColor &hoverBg, const QColor &primaryColor,
+                                         const QFont &font) const
+{
+    return QString(R"(
+        QWidget { background-color: %1; color: %2; font-family: "%6"; font-size: %7pt; }
+        QLineEdit { background-color: %5; border: 1px solid %5; border-radius: 2px; padding: 4px; }
+        QLineEdit:focus { border: 1px solid %8; }
+        QCheckBox { spacing: 4px; }
+        QListView { background-color: %1; border: none; outline: none; }
+        QListView::item { padding: 2px 4px; border: none; min-height: 20px; }
+        QListView::item:hover { background-color: %5; }
+        QListView::item:selected { background-color: %8; color: %4; }
+        QListView::item:selected:!active { background-color: %3; }
+    )")
+        .arg(bgColor.name())
+        .arg(fgColor.name())
+        .arg(selectionBg.name())
+        .arg(selectionFg.name())
+        .arg(hoverBg.name())
+        .arg(font.family())
+        .arg(font.pointSize())
+        .arg(primaryColor.name());
+}
+
 QString StyleHelper::getTabWidgetStyle(const QColor &bgColor, const QColor &fgColor) const
 {
     QString accent = fgColor.name();
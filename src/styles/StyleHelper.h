@@ -20,6 +20,11 @@ public:
                              const QColor &hoverBg, const QColor &primaryColor,
                              const QFont &font) const;
 
+    QString getSearchPanelStyle(const QColor &bgColor, const QColor &fgColor,
+                                const QColor &selectionBg, const QColor &selectionFg,
+                                const QColor &hoverBg, const QColor &primaryColor,
+                                const QFont &font) const;
+
     QString getTabWidgetStyle(const QColor &bgColor, const QColor &fgColor) const;
 
     QString getLabelStyle(const QColor &fgColor) const;
@@ -9,6 +9,9 @@
 #include <QVariant>
 #include "../logging/VoltLogger.h"
 
+#include <algorithm>
+#include <vector>
+
 Theme &Theme::instance()
 {
     static Theme instance;
@@ -22,7 +25,9 @@ void Theme::loadTheme(const QString &themeName)
 
     VOLT_THEME_F("Loading theme from: %1", themePath);
     loadJsonTheme(themePath);
+    resolveSlots();
     m_currentTheme = themeName;
+    ++m_generation;
     emit themeChanged();
 }
 
@@ -111,6 +116,47 @@ void Theme::loadJsonTheme(const QString &themePath)
     }
 }
 
+namespace {
+
+#define VOLT_THEME_KEY_NAME(name, key) QStringLiteral(key),
+
+const QString colorKeyNames[] = {VOLT_THEME_COLORS(VOLT_THEME_KEY_NAME)};
+const QString fontKeyNames[] = {VOLT_THEME_FONTS(VOLT_THEME_KEY_NAME)};
+const QString dimensionKeyNames[] = {VOLT_THEME_DIMENSIONS(VOLT_THEME_KEY_NAME)};
+
+#undef VOLT_THEME_KEY_NAME
+
+}
+
+//* Copies the schema keys out of the string maps into their array slots *//
+void Theme::resolveSlots()
+{
+    for (size_t i = 0; i < ThemeColorCount; ++i)
+    {
+        m_colorSlots[i] = m_colors.value(colorKeyNames[i]);
+    }
+    for (size_t i = 0; i < ThemeFontCount; ++i)
+    {
+        m_fontSlots[i] = m_fonts.value(fontKeyNames[i]);
+    }
+    for (size_t i = 0; i < ThemeDimensionCount; ++i)
+    {
+        m_dimensionSlots[i] = m_dimensions.value(dimensionKeyNames[i]);
+    }
+}
+
+int Theme::getDimensionInt(ThemeDimension key, int fallback) const
+{
+    const QVariant &value = m_dimensionSlots[size_t(key)];
+    return value.isValid() ? value.toInt() : fallback;
+}
+
+QMargins Theme::getDimensionMarginsFromArray(ThemeDimension key, const QMargins &fallback) const
+{
+    const QVariant &value = m_dimensionSlots[size_t(key)];
+    return value.canConvert<QMargins>() ? value.value<QMargins>() : fallback;
+}
+
 QColor Theme::getColor(const QString &key) const
 {
     auto it = m_colors.find(key);
@@ -256,51 +302,83 @@ QString Theme::getStyleString(const QString &styleKey, const QString &property,
     return fallback;
 }
 
-QChar Theme::getCarbonIconChar(const QString &iconName) const
+namespace {
+
+struct CarbonIcon
 {
-    QFile file(":/icons/icons-carbon.json");
-    if (!file.open(QIODevice::ReadOnly))
-    {
-        VOLT_ERROR("Failed to open icons-carbon.json file");
-        return QChar(); // Return invalid character
-    }
+    QString name;
+    QChar glyph;
+};
+
+/*
+ * icons-carbon.json is parsed on first use only, into a name-sorted table
+ * that lookups binary search without allocating.
+ */
+const std::vector<CarbonIcon> &carbonIcons()
+{
+    static const std::vector<CarbonIcon> icons = []() {
+        std::vector<CarbonIcon> table;
 
-    QByteArray data = file.readAll();
-    QJsonDocument doc = QJsonDocument::fromJson(data);
+        QFile file(":/icons/icons-carbon.json");
+        if (!file.open(QIODevice::ReadOnly))
+        {
+            VOLT_ERROR("Failed to open icons-carbon.json file");
+            return table;
+        }
 
-    if (doc.isNull())
-    {
-        VOLT_ERROR("Failed to parse icons-carbon.json file");
-        return QChar();
-    }
+        QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+        if (doc.isNull())
+        {
+            VOLT_ERROR("Failed to parse icons-carbon.json file");
+            return table;
+        }
 
-    QJsonObject root = doc.object();
-    QJsonObject iconDefinitions = root["iconDefinitions"].toObject();
+        QJsonObject iconDefinitions = doc.object()["iconDefinitions"].toObject();
+        table.reserve(size_t(iconDefinitions.size()));
+        for (auto it = iconDefinitions.begin(); it != iconDefinitions.end(); ++it)
+        {
+            QString fontCharacter = it.value().toObject()["fontCharacter"].toString();
 
-    if (!iconDefinitions.contains(iconName))
-    {
-        // VOLT_ERROR_F("Icon '%1' not found in icons-carbon.json", iconName);
-        return QChar();
-    }
+            // Convert unicode escape sequence (e.g., "\\e081") to actual unicode value
+            bool ok = false;
+            int unicodeValue = 0;
+            if (fontCharacter.startsWith("\\e"))
+            {
+                // Extract the hex part after \e and add the 0xe000 private use area base
+                unicodeValue = 0xe000 + fontCharacter.mid(2).toInt(&ok, 16);
+            }
+            if (!ok)
+            {
+                VOLT_ERROR_F("Invalid font character format for icon '%1'", it.key());
+                VOLT_ERROR_F("Font character value was: %1", fontCharacter);
+                continue;
+            }
+            table.push_back({it.key(), QChar(unicodeValue)});
+        }
+
+        //? QJsonObject iterates in key order already, sort anyway so lookups never depend on it
+        std::sort(table.begin(), table.end(),
+                  [](const CarbonIcon &a, const CarbonIcon &b) { return a.name < b.name; });
+        return table;
+    }();
+    return icons;
+}
 
-    QJsonObject iconObj = iconDefinitions[iconName].toObject();
-    QString fontCharacter = iconObj["fontCharacter"].toString();
+}
 
-    // Convert unicode escape sequence (e.g., "\\e081") to actual unicode value
-    if (fontCharacter.startsWith("\\e"))
+QChar Theme::getCarbonIconChar(const QString &iconName) const
+{
+    return getCarbonIconChar(QStringView(iconName));
+}
+
+QChar Theme::getCarbonIconChar(QStringView iconName) const
+{
+    const std::vector<CarbonIcon> &icons = carbonIcons();
+    auto it = std::lower_bound(icons.begin(), icons.end(), iconName,
+                               [](const CarbonIcon &icon, QStringView name) { return QStringView(icon.name) < name; });
+    if (it == icons.end() || it->name != iconName)
     {
-        bool ok;
-        // Extract the hex part after \e (e.g., "081" from "\\e081")
-        QString hexPart = fontCharacter.mid(2);
-        // Convert to unicode value, adding 0xe000 base for private use area
-        int unicodeValue = 0xe000 + hexPart.toInt(&ok, 16);
-        if (ok)
-        {
-            return QChar(unicodeValue);
-        }
+        return QChar();
     }
-
-    VOLT_ERROR_F("Invalid font character format for icon '%1'", iconName);
-    VOLT_ERROR_F("Font character value was: %1", fontCharacter);
-    return QChar();
+    return it->glyph;
 }
\ No newline at end of file
@@ -8,6 +8,9 @@
 #include <QSize>
 #include <QString>
 #include <QVariant>
+#include <array>
+
+#include "ThemeKeys.h"
 
 class Theme : public QObject {
   Q_OBJECT
@@ -17,6 +20,19 @@ public:
 
   void loadTheme(const QString &themeName);
   QString currentTheme() const { return m_currentTheme; }
+  // Bumped on every theme load, widgets can keep resolved values while it is unchanged
+  quint64 generation() const { return m_generation; }
+
+  // Slot lookups for keys of the theme schema, see ThemeKeys.h
+  const QColor &getColor(ThemeColor key) const {
+    return m_colorSlots[size_t(key)];
+  }
+  const QFont &getFont(ThemeFont key) const {
+    return m_fontSlots[size_t(key)];
+  }
+  int getDimensionInt(ThemeDimension key, int fallback = 0) const;
+  QMargins getDimensionMarginsFromArray(ThemeDimension key,
+                                        const QMargins &fallback = QMargins()) const;
 
   // Getters
   QColor getColor(const QString &key) const;
@@ -36,8 +52,9 @@ public:
 
   QString getStyle(const QString &key, QString fallback = QString()) const;
 
-  // Carbon icon helper
+  // Carbon icon helper, the icon table is parsed once on first use
   QChar getCarbonIconChar(const QString &iconName) const;
+  QChar getCarbonIconChar(QStringView iconName) const;
 
   // Style helper methods for accessing nested properties
   bool getStyleBool(const QString &styleKey, const QString &property,
@@ -53,10 +70,16 @@ signals:
 private:
   Theme() = default;
   void loadJsonTheme(const QString &themePath);
+  void resolveSlots();
 
   QString m_currentTheme;
   QMap<QString, QColor> m_colors;
   QMap<QString, QFont> m_fonts;
   QMap<QString, QVariant> m_dimensions;
   QMap<QString, QString> m_styles;
+
+  std::array<QColor, ThemeColorCount> m_colorSlots;
+  std::array<QFont, ThemeFontCount> m_fontSlots;
+  std::array<QVariant, ThemeDimensionCount> m_dimensionSlots;
+  quint64 m_generation = 0;
 };
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+
+/*
+ * Compile-time theme keys, mirroring the schema of themes/themes/dark.json.
+ *
+ * Every X(Name, "json.key") entry becomes a slot of ThemeColor, ThemeFont or
+ * ThemeDimension. Theme fills one flat array per kind when a theme loads, so
+ * a lookup by slot is an array index instead of a string map search. Keys a
+ * theme does not define stay empty, like an unknown string key did.
+ *
+ * Add the key here when it is added to the theme schema.
+ */
+
+#define VOLT_THEME_COLORS(X)                                      \
+    X(Primary, "primary")                                         \
+    X(Secondary, "secondary")                                     \
+    X(HoverColor, "hoverColor")                                   \
+    X(EditorBackground, "editor.background")                      \
+    X(EditorForeground, "editor.foreground")                      \
+    X(EditorLineNumberBackground, "editor.lineNumber.background") \
+    X(EditorLineNumberForeground, "editor.lineNumber.foreground") \
+    X(EditorCursor, "editor.cursor")                              \
+    X(EditorIndentGuide, "editor.indent.guide")                   \
+    X(EditorSelectionBackground, "editor.selectionBackground")    \
+    X(EditorSelectionForeground, "editor.selectionForeground")    \
+    X(EditorCurrentLine, "editor.currentLine")                    \
+    X(EditorMatchingBrace, "editor.matchingBrace")                \
+    X(EditorTabBackground, "editor.tab.background")               \
+    X(StatusBarBackground, "statusBar.background")                \
+    X(StatusBarForeground, "statusBar.foreground")                \
+    X(StatusBarBorder, "statusBar.border")                        \
+    X(MenuBackground, "menu.background")                          \
+    X(MenuForeground, "menu.foreground")                          \
+    X(MenuSelectionBackground, "menu.selectionBackground")        \
+    X(MenuSelectionForeground, "menu.selectionForeground")        \
+    X(MenuBorder, "menu.border")                                  \
+    X(ButtonForeground, "button.foreground")                      \
+    X(SyntaxComment, "syntax.comment")                            \
+    X(SyntaxString, "syntax.string")                              \
+    X(SyntaxNumber, "syntax.number")                              \
+    X(SyntaxKeyword, "syntax.keyword")                            \
+    X(SyntaxClass, "syntax.class")                                \
+    X(SyntaxFunction, "syntax.function")                          \
+    X(SyntaxVariable, "syntax.variable")                          \
+    X(SyntaxOperator, "syntax.operator")                          \
+    X(SyntaxType, "syntax.type")                                  \
+    X(SyntaxPreprocessor, "syntax.preprocessor")                  \
+    X(SyntaxEscape, "syntax.escape")                              \
+    X(SyntaxRegex, "syntax.regex")                                \
+    X(SyntaxIdentifier, "syntax.identifier")                      \
+    X(ScrollbarBackground, "scrollbar.background")                \
+    X(ScrollbarHandle, "scrollbar.handle")                        \
+    X(ScrollbarHandleHover, "scrollbar.handleHover")              \
+    X(ScrollbarHandlePressed, "scrollbar.handlePressed")          \
+    X(ScrollbarCorner, "scrollbar.corner")                        \
+    X(EditorModifiedIndicator, "editor.modifiedIndicator")
+
+#define VOLT_THEME_FONTS(X)   \
+    X(Editor, "editor")       \
+    X(Menu, "menu")           \
+    X(StatusBar, "statusBar") \
+    X(Explorer, "explorer")
+
+#define VOLT_THEME_DIMENSIONS(X)                                     \
+    X(EditorTabWidth, "editor.tabWidth")                             \
+    X(EditorMargins, "editor.margins")                               \
+    X(EditorLineHeight, "editor.lineHeight")                         \
+    X(EditorLetterSpacing, "editor.letterSpacing")                   \
+    X(StatusBarHeight, "statusBar.height")                           \
+    X(StatusBarPadding, "statusBar.padding")                         \
+    X(MenuItemHeight, "menu.itemHeight")                             \
+    X(MenuPadding, "menu.padding")                                   \
+    X(MenuSeparatorHeight, "menu.separatorHeight")                   \
+    X(ScrollbarWidth, "scrollbar.width")                             \
+    X(ScrollbarHandleRadius, "scrollbar.handleRadius")               \
+    X(ScrollbarHandleMargin, "scrollbar.handleMargin")               \
+    X(ScrollbarMinimumHandleLength, "scrollbar.minimumHandleLength")
+
+#define VOLT_THEME_ENUM_ENTRY(name, key) name,
+
+enum class ThemeColor
+{
+    VOLT_THEME_COLORS(VOLT_THEME_ENUM_ENTRY)
+    Count
+};
+
+enum class ThemeFont
+{
+    VOLT_THEME_FONTS(VOLT_THEME_ENUM_ENTRY)
+    Count
+};
+
+enum class ThemeDimension
+{
+    VOLT_THEME_DIMENSIONS(VOLT_THEME_ENUM_ENTRY)
+    Count
+};
+
+#undef VOLT_THEME_ENUM_ENTRY
+
+constexpr size_t ThemeColorCount = size_t(ThemeColor::Count);
+constexpr size_t ThemeFontCount = size_t(ThemeFont::Count);
+constexpr size_t ThemeDimensionCount = size_t(ThemeDimension::Count);
@@ -0,0 +1,72 @@
+#include <QCoreApplication>
+#include <QFile>
+#include <iostream>
+#include "logging/BinaryLog.h"
+
+/*
+ * Decodes binary Volt logs (volt.vlog, volt.vlog.1) back into the text log layout.
+ *
+ * Usage: volt_logdecode <file.vlog>...
+ * Files are decoded in the order given, so pass the rotated segment first.
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList files = app.arguments().mid(1);
+    if (files.isEmpty())
+    {
+        std::cerr << "Usage: volt_logdecode <file.vlog>..." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int status = EXIT_SUCCESS;
+    for (const QString &path : files)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly))
+        {
+            std::cerr << "Cannot open " << path.toStdString() << std::endl;
+            status = EXIT_FAILURE;
+            continue;
+        }
+
+        const QByteArray data = file.readAll();
+        const uchar *bytes = reinterpret_cast<const uchar *>(data.constData());
+        BinaryLog::SegmentHeader header;
+        if (!BinaryLog::readHeader(bytes, data.size(), header))
+        {
+            std::cerr << path.toStdString() << " is not a Volt binary log" << std::endl;
+            status = EXIT_FAILURE;
+            continue;
+        }
+
+        BinaryLog::Definitions definitions;
+        BinaryLog::forEachFrame(bytes, data.size(), [&](quint8 type, const uchar *payload, int size)
+        {
+            if (type == BinaryLog::FrameRecord)
+            {
+                BinaryLog::Record record;
+                if (BinaryLog::decodeRecord(payload, size, header.baseTimestamp, record))
+                {
+                    std::cout << definitions.line(record).toStdString() << '\n';
+                }
+                return;
+            }
+            if (type != BinaryLog::FrameFormat && type != BinaryLog::FrameCategory)
+            {
+                return;
+            }
+
+            quint32 id = 0;
+            QString text;
+            BinaryLog::FormatStyle style = BinaryLog::StylePercent;
+            if (BinaryLog::decodeDefinition(payload, size, id, text, style))
+            {
+                definitions.define(BinaryLog::FrameType(type), id, text, style);
+            }
+        });
+    }
+
+    std::cout.flush();
+    return status;
+}
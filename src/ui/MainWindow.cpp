@@ -13,15 +13,23 @@
 #include <QGuiApplication>
 #include <QClipboard>
 #include <QFileInfo>
-#include <QTextStream>
 #include <QMessageBox>
 #include <QAction>
 #include <QKeySequence>
 #include "../editor/CodeEditor.h"
 #include "../editor/Minimap.h"
+#include "../editor/FileLoader.h"
+#include "../editor/DensityBar.h"
+#include "../editor/DocumentRegistry.h"
+#include "components/QuickOpen.h"
+#include "components/PerfPanel.h"
 #include <QHBoxLayout>
+#include <QSplitter>
+#include <QPointer>
+#include <algorithm>
 #include "../themes/Theme.h"
 #include "../logging/VoltLogger.h"
+#include "../logging/VoltTrace.h"
 #include "../styles/StyleManager.h"
 
 MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
@@ -30,6 +38,9 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
     resize(1200, 800);
 
     setupEditor();
+    //? Created after the tab widget so it is destroyed after it, closing tabs on teardown still finds it
+    documents = new DocumentRegistry(this);
+    connect(documents, &DocumentRegistry::pathChanged, this, &MainWindow::onDocumentPathChanged);
     setupMenuBar();
     setupStatusBar();
     setupSidebar();
@@ -65,6 +76,17 @@ void MainWindow::setupMenuBar()
     fileMenu = new FileMenu(this);
     fileMenu->setMainWindow(this);
     menuBar()->addMenu(fileMenu);
+
+    //* Debug panel, reachable by shortcut only *//
+    QAction *perfPanelAction = new QAction("Performance Panel", this);
+    perfPanelAction->setShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_F12));
+    connect(perfPanelAction, &QAction::triggered, this, &MainWindow::showPerfPanel);
+    addAction(perfPanelAction);
+
+    QAction *splitAction = new QAction("Split Editor", this);
+    splitAction->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_Backslash));
+    connect(splitAction, &QAction::triggered, this, &MainWindow::splitCurrentEditor);
+    addAction(splitAction);
 }
 
 void MainWindow::setupStatusBar()
@@ -81,6 +103,35 @@ void MainWindow::setupSidebar()
     // Connect sidebar signals
     connect(sidebar, &Sidebar::fileDoubleClicked,
             this, &MainWindow::openFile);
+    connect(sidebar, &Sidebar::searchMatchActivated,
+            this, &MainWindow::openFileAt);
+    connect(fileMenu, &FileMenu::fileSaved,
+            sidebar, &Sidebar::notifyFileSaved);
+
+    //* Quick open indexes whatever folder the sidebar shows *//
+    quickOpen = new QuickOpen(this);
+    connect(sidebar, &Sidebar::folderChanged,
+            quickOpen, &QuickOpen::setRootPath);
+    connect(sidebar, &Sidebar::fileCreated,
+            quickOpen, &QuickOpen::refreshIndex);
+    connect(quickOpen, &QuickOpen::fileSelected,
+            this, &MainWindow::openFile);
+}
+
+void MainWindow::showQuickOpen()
+{
+    quickOpen->popup();
+}
+
+void MainWindow::showPerfPanel()
+{
+    if (!perfPanel)
+    {
+        perfPanel = new PerfPanel(this);
+    }
+    perfPanel->show();
+    perfPanel->raise();
+    perfPanel->activateWindow();
 }
 
 /*
@@ -105,21 +156,18 @@ void MainWindow::applyTheme()
             customTabBar->applyTheme();
         }
         
-        for (int i = 0; i < editorTab->count(); ++i)
+        //* Only the shown views are updated now, the others catch up when their tab is shown *//
+        QWidget *container = editorTab->currentWidget();
+        DocumentRegistry::Document *document = container ? documents->forTab(container) : nullptr;
+        if (document)
         {
-            CodeEditor *ed = qobject_cast<CodeEditor *>(editorTab->widget(i));
-            if (ed)
+            for (CodeEditor *view : document->editors)
             {
-                ed->refreshTheme();
+                view->refreshTheme();
             }
         }
     }
 
-    if (statusBar)
-    {
-        statusBar->applyTheme();
-    }
-
     if (menuBar())
     {
         QColor menuBg = theme.getColor("menu.background");
@@ -164,132 +212,284 @@ void MainWindow::onThemeChanged()
 {
     VOLT_THEME("Theme changed, refreshing MainWindow components");
     applyTheme();
+}
 
-    if (editorTab)
+void MainWindow::openFile(const QString &filePath)
+{
+    VOLT_TRACE_SCOPE("MainWindow::openFile");
+    if (DocumentRegistry::Document *document = addDocumentTab(filePath))
     {
-        for (int i = 0; i < editorTab->count(); i++)
+        //* Becoming the current tab is what creates the editor *//
+        editorTab->setCurrentWidget(document->tab);
+    }
+}
+
+/*
+ * Opens several files at once, e.g. from the command line. Every file gets
+ * a placeholder tab; only the last one, which is shown, gets an editor.
+ */
+void MainWindow::openFiles(const QStringList &filePaths)
+{
+    VOLT_TRACE_SCOPE("MainWindow::openFiles");
+    DocumentRegistry::Document *last = nullptr;
+    for (const QString &filePath : filePaths)
+    {
+        if (DocumentRegistry::Document *document = addDocumentTab(filePath))
         {
-            CodeEditor *ed = qobject_cast<CodeEditor *>(editorTab->widget(i));
-            if (ed)
-            {
-                ed->refreshTheme();
-            }
+            last = document;
         }
     }
-
-    if (statusBar)
+    if (last)
     {
-        statusBar->applyTheme();
+        editorTab->setCurrentWidget(last->tab);
     }
 }
 
-static int findTabIndexForPath(QTabWidget *tabWidget, const QString &filePath)
+/*
+ * The tab of an open file, or a new placeholder tab for it. A placeholder
+ * is an empty splitter plus the registry entry with the path and size, the
+ * editor, document and minimap are only created once the tab is shown.
+ */
+DocumentRegistry::Document *MainWindow::addDocumentTab(const QString &filePath)
 {
-    VOLT_DEBUG_F("Finding tab index for path: %1", filePath);
-    if (!tabWidget || filePath.isEmpty())
+    QFileInfo fileInfo(filePath);
+    if (!fileInfo.exists() || !fileInfo.isFile())
     {
-        VOLT_DEBUG("Invalid tab widget or file path");
-        return -1;
+        QMessageBox::warning(this, "Error", "File does not exist: " + filePath);
+        return nullptr;
     }
 
-    for (int i = 0; i < tabWidget->count(); ++i)
+    if (DocumentRegistry::Document *existing = documents->find(filePath))
     {
-        VOLT_DEBUG_F("Checking tab %1", i);
-
-        QVariant data;
-        if (tabWidget->tabBar())
-        {
-            data = tabWidget->tabBar()->tabData(i);
-        }
-        if (data.isValid() && data.toString() == filePath)
-        {
-            return i;
-        }
-
-        QString tabPath = tabWidget->tabToolTip(i);
-        if (tabPath == filePath)
-        {
-            return i;
-        }
-
-        QString tabText = tabWidget->tabText(i);
-        if (tabText == QFileInfo(filePath).fileName())
-        {
-            return i;
-        }
+        return existing;
     }
 
-    return -1;
+    //* The tab page is a splitter of views, split editors add panes next to the first one *//
+    QSplitter *container = new QSplitter(Qt::Horizontal, this);
+    container->setChildrenCollapsible(false);
+    container->setHandleWidth(1);
+
+    //* Registered before the tab is added, the first tab becomes current inside addTab *//
+    DocumentRegistry::Document *document = documents->add(filePath, container);
+    document->size = fileInfo.size();
+    int idx = editorTab->addTab(container, fileInfo.fileName());
+    editorTab->setTabToolTip(idx, filePath);
+    return document;
 }
 
-void MainWindow::openFile(const QString &filePath)
+/*
+ * Creates the editor of a placeholder tab and starts loading the file into
+ * it. Returns false if the file cannot be opened any more, the tab is closed
+ * then from the event loop: this runs inside tab changes, even inside
+ * addTab for the first tab, and the callers still hold the document.
+ */
+bool MainWindow::materializeDocument(DocumentRegistry::Document *document)
 {
-    QFileInfo fileInfo(filePath);
-    if (!fileInfo.exists() || !fileInfo.isFile())
-    {
-        QMessageBox::warning(this, "Error", "File does not exist: " + filePath);
-        return;
-    }
+    VOLT_TRACE_SCOPE("MainWindow::materializeDocument");
+    const QString filePath = document->path;
+    QSplitter *container = static_cast<QSplitter *>(document->tab);
 
-    int existingIndex = findTabIndexForPath(editorTab, filePath);
-    if (existingIndex != -1)
+    bool largeFile = document->size >= largeFileThreshold;
+    if (largeFile)
     {
-        editorTab->setCurrentIndex(existingIndex);
-        return;
+        VOLT_INFO_F2("Opening %1 in large file mode (%2 bytes)", filePath, document->size);
     }
+    CodeEditor *editor = new CodeEditor(this, largeFile);
 
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    //* The loader maps the file and streams it into the editor's document *//
+    FileLoader *loader = new FileLoader(editor, filePath, editor);
+    if (!loader->open())
     {
         QMessageBox::warning(this, "Error", "Cannot open file: " + filePath);
-        return;
+        delete editor;
+        QPointer<QWidget> tab = container;
+        QMetaObject::invokeMethod(this, [this, tab]() {
+            if (tab)
+                onTabCloseRequested(editorTab->indexOf(tab));
+        }, Qt::QueuedConnection);
+        return false;
     }
-
-    QTextStream in(&file);
-    QString content = in.readAll();
-    file.close();
-
-    CodeEditor *editor = new CodeEditor(this);
     
     VOLT_DEBUG("Connecting text changed signal");
     
-    //? Connect text changed signal BEFORE setting text
+    //? Connect text changed signal BEFORE loading text
     connect(editor, &CodeEditor::fileModificationChanged,
             this, &MainWindow::onFileModificationChanged);
     
     //! Block signals during initial file load to prevent false modification detection
     editor->setLoadingFile(true);
-    editor->setText(content);
-    editor->setLoadingFile(false);
-    
-    // * Mark this content as the "saved" baseline for comparison
-    editor->markAsSaved();
 
+    QString fileName = QFileInfo(filePath).fileName();
+    StatusBar *bar = statusBar;
+    connect(loader, &FileLoader::progressChanged, bar, [bar, fileName](int percent) {
+        bar->updateLoadProgress(fileName, percent);
+    });
+    connect(loader, &QObject::destroyed, bar, [bar]() {
+        bar->updateLoadProgress(QString(), 100);
+    });
+    connect(loader, &FileLoader::finished, this, [editor, loader](bool success) {
+        if (!success)
+        {
+            VOLT_WARN_F("Loading did not complete: %1", loader->filePath());
+        }
+
+        editor->setLoadingFile(false);
+
+        // * Mark this content as the "saved" baseline for comparison
+        editor->markAsSaved();
+        loader->deleteLater();
+    });
+
+    documents->addView(document, editor);
+    container->addWidget(createEditorPane(editor, container));
+
+    //* Small files finish inside start(), large ones keep loading on a worker thread *//
+    loader->start();
+    return true;
+}
+
+/*
+ * Turns editors of tabs that have not been shown for the longest time back
+ * into placeholders until the open files fit the budget. Only documents
+ * without unsaved changes are evicted, reopening them reloads from disk.
+ * Scintilla's own modified flag and undo history are checked as well, so
+ * edits are never dropped even if the editor's dirty flag missed them.
+ */
+void MainWindow::evictIdleEditors()
+{
+    qint64 materializedBytes = 0;
+    QList<DocumentRegistry::Document *> candidates;
+    const QList<DocumentRegistry::Document *> all = documents->all();
+    for (DocumentRegistry::Document *document : all)
+    {
+        if (document->editors.isEmpty())
+            continue;
+
+        materializedBytes += document->size;
+        if (document->tab == editorTab->currentWidget())
+            continue;
+
+        bool busy = false;
+        for (CodeEditor *view : document->editors)
+        {
+            busy = busy || view->hasUnsavedChanges() || view->isLoading()
+                   || view->SendScintilla(QsciScintillaBase::SCI_GETMODIFY)
+                   || view->SendScintilla(QsciScintillaBase::SCI_CANUNDO);
+        }
+        if (!busy)
+            candidates.append(document);
+    }
+
+    if (materializedBytes <= editorMemoryBudget)
+        return;
+
+    std::sort(candidates.begin(), candidates.end(),
+              [](const DocumentRegistry::Document *a, const DocumentRegistry::Document *b) {
+                  return a->lastShown < b->lastShown;
+              });
+
+    for (DocumentRegistry::Document *document : candidates)
+    {
+        if (materializedBytes <= editorMemoryBudget)
+            break;
+
+        VOLT_DEBUG_F("Evicting the editor of %1", document->path);
+        const QList<CodeEditor *> views = documents->clearViews(document);
+        for (CodeEditor *view : views)
+        {
+            view->parentWidget()->deleteLater();
+        }
+        materializedBytes -= document->size;
+    }
+}
+
+/*
+ * One view of a document: the editor with its own minimap, or density bar
+ * in large file mode, next to it.
+ */
+QWidget *MainWindow::createEditorPane(CodeEditor *editor, QWidget *parent)
+{
     StyleManager::setupWidgetScrollbars(editor);
     editor->refreshTheme();
-    editor->setStyleSheet("QsciScintilla { background-color: #1e1e1e, border: none; outline: none; }");
 
-    QWidget *container = new QWidget(this);
-    QHBoxLayout *h = new QHBoxLayout(container);
+    QWidget *pane = new QWidget(parent);
+    QHBoxLayout *h = new QHBoxLayout(pane);
     h->setContentsMargins(0, 0, 0, 0);
     h->setSpacing(4);
-    container->setLayout(h);
+    pane->setLayout(h);
     h->addWidget(editor, 1);
-    Minimap *minimap = new Minimap(editor, container);
-    h->addWidget(minimap);
+    if (editor->isLargeFileMode())
+    {
+        h->addWidget(new DensityBar(editor, pane));
+    }
+    else
+    {
+        h->addWidget(new Minimap(editor, pane));
+    }
+    return pane;
+}
 
-    int idx = editorTab->addTab(container, fileInfo.fileName());
-    editorTab->setTabToolTip(idx, filePath);
-    if (editorTab->tabBar())
+/*
+ * Adds another view of the current tab's document to the right. The new
+ * editor shares the Scintilla document, so a file viewed twice is held in
+ * memory once and styled once.
+ */
+void MainWindow::splitCurrentEditor()
+{
+    QSplitter *container = qobject_cast<QSplitter *>(editorTab->currentWidget());
+    DocumentRegistry::Document *document = container ? documents->forTab(container) : nullptr;
+    if (!document || document->editors.isEmpty())
+        return;
+
+    //* A background load swaps a new document into the first view when it finishes *//
+    CodeEditor *source = document->editors.first();
+    if (source->isLoading())
     {
-        editorTab->tabBar()->setTabData(idx, filePath);
+        VOLT_INFO("Split ignored, the file is still loading");
+        return;
     }
-    editorTab->setCurrentIndex(idx);
 
-    setWindowTitle(QString(" - %1").arg(fileInfo.fileName()));
+    CodeEditor *view = new CodeEditor(this, source->isLargeFileMode());
+    view->shareDocument(source);
+    connect(view, &CodeEditor::fileModificationChanged,
+            this, &MainWindow::onFileModificationChanged);
+
+    documents->addView(document, view);
+    container->addWidget(createEditorPane(view, container));
+    view->setFocus();
 }
 
+//* Closes every view of the current tab but the first, the document stays open *//
+void MainWindow::unsplitCurrentEditor()
+{
+    QWidget *container = editorTab->currentWidget();
+    DocumentRegistry::Document *document = container ? documents->forTab(container) : nullptr;
+    if (!document)
+        return;
 
+    const QList<CodeEditor *> views = document->editors.mid(1);
+    for (CodeEditor *view : views)
+    {
+        documents->removeView(view);
+        view->parentWidget()->deleteLater();
+    }
+    document->editors.first()->setFocus();
+}
+
+/*
+ * Opens (or switches to) a file and jumps to a position in it.
+ * Used by the search panel, the jump waits for the file if it is still loading.
+ */
+void MainWindow::openFileAt(const QString &filePath, int line, int column)
+{
+    openFile(filePath);
+
+    DocumentRegistry::Document *document = documents->find(filePath);
+    if (document && !document->editors.isEmpty())
+    {
+        document->editors.first()->goToLine(line, column);
+    }
+}
 
 void MainWindow::openFolder(const QString &folderPath)
 {
@@ -306,26 +506,60 @@ void MainWindow::onTabCloseRequested(int index)
         return;
 
     QWidget *widget = editorTab->widget(index);
+    documents->removeTab(widget);
     editorTab->removeTab(index);
     if (widget)
         widget->deleteLater();
 
-    int currentIndex = editorTab->currentIndex();
-    if (currentIndex >= 0)
+    updateWindowTitle();
+}
+
+/*
+ * Closes several tabs at once. Placeholders that become current in between
+ * are not materialized, only the tab left current at the end is.
+ */
+void MainWindow::closeTabs(const QList<QWidget *> &tabs)
+{
+    closingTabs = true;
+    for (QWidget *tab : tabs)
     {
-        QVariant data;
-        if (editorTab->tabBar())
-        {
-            data = editorTab->tabBar()->tabData(currentIndex);
-        }
-        QString path = data.toString();
-        QFileInfo fi(path);
-        QString name = fi.exists() ? fi.fileName() : editorTab->tabText(currentIndex);
-        setWindowTitle(QString("Volt Editor - %1").arg(name));
+        onTabCloseRequested(editorTab->indexOf(tab));
     }
-    else
+    closingTabs = false;
+
+    onCurrentTabChanged(editorTab->currentIndex());
+}
+
+/*
+ * Window title for the current tab, the name comes from the document's
+ * path so no file system access is needed.
+ */
+void MainWindow::updateWindowTitle()
+{
+    QWidget *container = editorTab->currentWidget();
+    if (!container)
     {
         setWindowTitle("Volt Editor");
+        return;
+    }
+
+    DocumentRegistry::Document *document = documents->forTab(container);
+    QString name = document ? QFileInfo(document->path).fileName() : editorTab->tabText(editorTab->currentIndex());
+    setWindowTitle(QString("Volt Editor - %1").arg(name));
+}
+
+//* Save As or a moved file, the tab follows the document *//
+void MainWindow::onDocumentPathChanged(DocumentRegistry::Document *document)
+{
+    int index = editorTab->indexOf(document->tab);
+    if (index < 0)
+        return;
+
+    editorTab->setTabText(index, QFileInfo(document->path).fileName());
+    editorTab->setTabToolTip(index, document->path);
+    if (index == editorTab->currentIndex())
+    {
+        updateWindowTitle();
     }
 }
 
@@ -343,8 +577,15 @@ void MainWindow::onTabContextMenuRequested(const QPoint &pos)
     QAction *closeAct = menu.addAction("Close");
     QAction *closeOthers = menu.addAction("Close Others");
     QAction *closeRight = menu.addAction("Close Tabs to the Right");
+    menu.addSeparator();
+    QAction *split = menu.addAction("Split Right");
+    QAction *unsplit = menu.addAction("Close Split");
+    menu.addSeparator();
     QAction *copyPath = menu.addAction("Copy Path");
 
+    DocumentRegistry::Document *document = documents->forTab(editorTab->widget(idx));
+    unsplit->setEnabled(document && document->editors.size() > 1);
+
     QAction *selected = menu.exec(tb->mapToGlobal(pos));
     if (!selected)
         return;
@@ -353,63 +594,74 @@ void MainWindow::onTabContextMenuRequested(const QPoint &pos)
     {
         onTabCloseRequested(idx);
     }
-    else if (selected == closeOthers)
+    else if (selected == closeOthers || selected == closeRight)
     {
-        for (int i = editorTab->count() - 1; i >= 0; --i)
+        QList<QWidget *> tabs;
+        for (int i = selected == closeOthers ? 0 : idx + 1; i < editorTab->count(); ++i)
         {
             if (i != idx)
-                onTabCloseRequested(i);
+                tabs.append(editorTab->widget(i));
         }
+        closeTabs(tabs);
     }
-    else if (selected == closeRight)
+    else if (selected == split || selected == unsplit)
     {
-        for (int i = editorTab->count() - 1; i > idx; --i)
-        {
-            onTabCloseRequested(i);
-        }
+        editorTab->setCurrentIndex(idx);
+        if (selected == split)
+            splitCurrentEditor();
+        else
+            unsplitCurrentEditor();
     }
     else if (selected == copyPath)
     {
-        QVariant data;
-        if (editorTab->tabBar())
-            data = editorTab->tabBar()->tabData(idx);
-        QString path = data.isValid() ? data.toString() : editorTab->tabToolTip(idx);
+        QString path = document ? document->path : editorTab->tabToolTip(idx);
         QGuiApplication::clipboard()->setText(path);
     }
 }
 
 void MainWindow::onCurrentTabChanged(int index)
 {
-    if (editorTab)
-    {
-        for (int i = 0; i < editorTab->count(); ++i)
-        {
-            CodeEditor *ed = qobject_cast<CodeEditor *>(editorTab->widget(i));
-            if (ed)
-            {
-                ed->refreshTheme();
-                StyleManager::setupWidgetScrollbars(ed);
-            }
-        }
-    }
+    //? Editors bring their theme up to date in showEvent, nothing to do for the other tabs
+
+    //* Placeholder tabs get their editor the first time they are shown, not while passing through a batch close *//
+    if (closingTabs)
+        return;
 
-    // Update window title
-    if (index >= 0 && index < editorTab->count())
+    QWidget *container = editorTab->widget(index);
+    DocumentRegistry::Document *document = container ? documents->forTab(container) : nullptr;
+    if (document)
     {
-        QVariant data;
-        if (editorTab->tabBar())
+        document->lastShown = ++showCounter;
+        if (document->editors.isEmpty())
         {
-            data = editorTab->tabBar()->tabData(index);
+            if (!materializeDocument(document))
+                return;
+            evictIdleEditors();
         }
-        QString path = data.toString();
-        QFileInfo fi(path);
-        QString name = fi.exists() ? fi.fileName() : editorTab->tabText(index);
-        setWindowTitle(QString("Volt Editor - %1").arg(name));
     }
-    else
+
+    CodeEditor *current = currentEditor();
+    statusBar->updateLargeFileMode(current && current->isLargeFileMode());
+    updateWindowTitle();
+}
+
+/*
+ * The editor of the current tab, if that tab holds a registered document.
+ * With a split editor this is the focused view, else the first one.
+ */
+CodeEditor *MainWindow::currentEditor() const
+{
+    QWidget *container = editorTab ? editorTab->currentWidget() : nullptr;
+    DocumentRegistry::Document *document = container ? documents->forTab(container) : nullptr;
+    if (!document || document->editors.isEmpty())
+        return nullptr;
+
+    for (CodeEditor *view : document->editors)
     {
-        setWindowTitle("Volt Editor");
+        if (view->hasFocus())
+            return view;
     }
+    return document->editors.first();
 }
 
 /*
@@ -423,22 +675,11 @@ void MainWindow::onFileModificationChanged(bool hasChanges)
     if (!senderEditor || !editorTab)
         return;
     
-    // Search for the tab containing this editor
-    for (int i = 0; i < editorTab->count(); ++i)
-    {
-        QWidget *container = editorTab->widget(i);
-        if (!container)
-            continue;
-            
-        CodeEditor *editor = container->findChild<CodeEditor*>();
-        if (editor == senderEditor)
-        {
-            updateTabModified(i, hasChanges);
-            
-            int modifiedCount = getModifiedFileCount();
-            break;
-        }
-    }
+    DocumentRegistry::Document *document = documents->forEditor(senderEditor);
+    if (!document)
+        return;
+
+    updateTabModified(editorTab->indexOf(document->tab), hasChanges);
 }
 
 /*
@@ -2,12 +2,16 @@
 #pragma once
 #include <QMainWindow>
 #include <QTabWidget>
+#include <QStringList>
 #include "statusbar/StatusBar.h"
 #include "sidebar/Sidebar.h"
 #include "components/CustomTabWidget.h"
 #include "../editor/CodeEditor.h"
+#include "../editor/DocumentRegistry.h"
 
 class FileMenu;
+class QuickOpen;
+class PerfPanel;
 
 class MainWindow : public QMainWindow
 {
@@ -21,8 +25,33 @@ public:
     
     // Public methods
     void openFile(const QString &filePath);
+    void openFiles(const QStringList &filePaths);
+    void openFileAt(const QString &filePath, int line, int column);
+    void showQuickOpen();
+    void showPerfPanel();
+    void splitCurrentEditor();
+    void unsplitCurrentEditor();
     void openFolder(const QString &folderPath);
 
+    // Open documents of this window, the one place that maps files to editors and tabs
+    DocumentRegistry &documentRegistry() { return *documents; }
+    CodeEditor *currentEditor() const;
+
+    // Files at or above this size open in large file mode
+    void setLargeFileThreshold(qint64 bytes) { largeFileThreshold = bytes; }
+    qint64 getLargeFileThreshold() const { return largeFileThreshold; }
+
+    static constexpr qint64 DefaultLargeFileThreshold = 64LL * 1024 * 1024;
+
+    // Tabs keep their editors while the shown files add up to this size, longest unvisited ones are evicted first
+    void setEditorMemoryBudget(qint64 bytes) { editorMemoryBudget = bytes; }
+    qint64 getEditorMemoryBudget() const { return editorMemoryBudget; }
+
+    static constexpr qint64 DefaultEditorMemoryBudget = 512LL * 1024 * 1024;
+
+    // The on-disk search index of the opened folder, on by default
+    void setSearchIndexEnabled(bool enabled) { sidebar->setSearchIndexEnabled(enabled); }
+
 signals:
     void fileModified();
 
@@ -32,6 +61,7 @@ private slots:
     void onCurrentTabChanged(int index);
     void onTabContextMenuRequested(const QPoint &pos);
     void onFileModificationChanged(bool hasChanges);
+    void onDocumentPathChanged(DocumentRegistry::Document *document);
 
 
 private:
@@ -44,11 +74,25 @@ private:
     void setupEditor();
     void setupSidebar();
     void applyTheme();
+    void updateWindowTitle();
+    void closeTabs(const QList<QWidget *> &tabs);
+    QWidget *createEditorPane(CodeEditor *editor, QWidget *parent);
+    DocumentRegistry::Document *addDocumentTab(const QString &filePath);
+    bool materializeDocument(DocumentRegistry::Document *document);
+    void evictIdleEditors();
     
     // UI elements
     StatusBar *statusBar;
     FileMenu *fileMenu;
     CustomTabWidget *editorTab;
     Sidebar *sidebar;
+    QuickOpen *quickOpen;
+    PerfPanel *perfPanel = nullptr;
+    DocumentRegistry *documents = nullptr;
+
+    qint64 largeFileThreshold = DefaultLargeFileThreshold;
+    qint64 editorMemoryBudget = DefaultEditorMemoryBudget;
+    quint64 showCounter = 0;
+    bool closingTabs = false;
 };
 
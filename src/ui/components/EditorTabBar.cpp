@@ -64,7 +64,7 @@ void EditorTabBar::paintEvent(QPaintEvent *event) {
     painter.setRenderHint(QPainter::Antialiasing);
     
     Theme &theme = Theme::instance();
-    QColor dotColor = theme.getColor("editor.modifiedIndicator");
+    const QColor &dotColor = theme.getColor(ThemeColor::EditorModifiedIndicator);
     
     for (int i = 0; i < count(); ++i) {
         if (m_modifiedTabs.value(i, false)) {
@@ -0,0 +1,114 @@
+#include "PerfPanel.h"
+#include "../../logging/PaintStats.h"
+#include "../../logging/UiWatchdog.h"
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QTimer>
+#include <QVBoxLayout>
+
+namespace
+{
+// Columns before the histogram buckets
+enum Column
+{
+    CountColumn,
+    AverageColumn,
+    MaxColumn,
+    FirstBucketColumn
+};
+}
+
+PerfPanel::PerfPanel(QWidget *parent)
+    : QDialog(parent),
+      m_table(new QTableWidget(PaintStats::SourceCount, FirstBucketColumn + PaintStats::BucketCount, this)),
+      m_stallLabel(new QLabel(this)),
+      m_refreshTimer(new QTimer(this))
+{
+    setWindowTitle("Performance");
+    resize(760, 200);
+
+    QStringList headers = {"Paints", "Avg ms", "Max ms"};
+    for (int bucket = 0; bucket < PaintStats::BucketCount; ++bucket)
+    {
+        headers.append(PaintStats::bucketLabel(bucket));
+    }
+    m_table->setHorizontalHeaderLabels(headers);
+
+    QStringList rows;
+    for (int source = 0; source < PaintStats::SourceCount; ++source)
+    {
+        rows.append(PaintStats::sourceName(PaintStats::Source(source)));
+    }
+    m_table->setVerticalHeaderLabels(rows);
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+
+    QPushButton *resetButton = new QPushButton("Reset", this);
+    connect(resetButton, &QPushButton::clicked, this, &PerfPanel::resetStats);
+
+    QHBoxLayout *footer = new QHBoxLayout();
+    footer->addWidget(m_stallLabel, 1);
+    footer->addWidget(resetButton);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addWidget(m_table);
+    layout->addLayout(footer);
+
+    m_refreshTimer->setInterval(RefreshIntervalMs);
+    connect(m_refreshTimer, &QTimer::timeout, this, &PerfPanel::refresh);
+}
+
+void PerfPanel::showEvent(QShowEvent *event)
+{
+    QDialog::showEvent(event);
+    refresh();
+    m_refreshTimer->start();
+}
+
+void PerfPanel::hideEvent(QHideEvent *event)
+{
+    m_refreshTimer->stop();
+    QDialog::hideEvent(event);
+}
+
+void PerfPanel::refresh()
+{
+    auto setCell = [this](int row, int column, const QString &text)
+    {
+        QTableWidgetItem *item = m_table->item(row, column);
+        if (!item)
+        {
+            item = new QTableWidgetItem();
+            item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            m_table->setItem(row, column, item);
+        }
+        item->setText(text);
+    };
+
+    for (int source = 0; source < PaintStats::SourceCount; ++source)
+    {
+        const PaintStats::Histogram &histogram = PaintStats::instance().histogram(PaintStats::Source(source));
+        double averageMs = histogram.count ? histogram.totalUs / 1000.0 / histogram.count : 0.0;
+        setCell(source, CountColumn, QString::number(histogram.count));
+        setCell(source, AverageColumn, QString::number(averageMs, 'f', 2));
+        setCell(source, MaxColumn, QString::number(histogram.maxUs / 1000.0, 'f', 2));
+        for (int bucket = 0; bucket < PaintStats::BucketCount; ++bucket)
+        {
+            setCell(source, FirstBucketColumn + bucket, QString::number(histogram.buckets[bucket]));
+        }
+    }
+
+    UiWatchdog &watchdog = UiWatchdog::instance();
+    m_stallLabel->setText(watchdog.isRunning()
+                              ? QString("UI stalls detected: %1").arg(watchdog.stallCount())
+                              : QString("UI stall watchdog is off"));
+}
+
+void PerfPanel::resetStats()
+{
+    PaintStats::instance().reset();
+    refresh();
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QDialog>
+
+class QLabel;
+class QTableWidget;
+class QTimer;
+
+/*
+ * Debug panel with the paint-time histograms from PaintStats and the UI
+ * stall count from UiWatchdog. Refreshes itself while visible.
+ */
+class PerfPanel : public QDialog
+{
+    Q_OBJECT
+public:
+    explicit PerfPanel(QWidget *parent = nullptr);
+
+    static constexpr int RefreshIntervalMs = 500;
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private slots:
+    void refresh();
+    void resetStats();
+
+private:
+    QTableWidget *m_table;
+    QLabel *m_stallLabel;
+    QTimer *m_refreshTimer;
+};
@@ -0,0 +1,186 @@
+#include "QuickOpen.h"
+#include "../../search/PathIndex.h"
+#include "../../themes/Theme.h"
+#include "../../styles/StyleHelper.h"
+
+#include <QKeyEvent>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QVBoxLayout>
+
+QuickOpen::QuickOpen(QWidget *parent)
+    : QFrame(parent),
+      m_input(new QLineEdit(this)),
+      m_list(new QListWidget(this)),
+      m_index(new PathIndex(this)),
+      m_lastGeneration(0)
+{
+    setObjectName("QuickOpen");
+    setFrameStyle(QFrame::Box);
+    hide();
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(6, 6, 6, 6);
+    layout->setSpacing(4);
+
+    m_input->setPlaceholderText("Search files by name");
+    m_input->installEventFilter(this);
+
+    m_list->setUniformItemSizes(true);
+    m_list->setFocusPolicy(Qt::NoFocus);
+    m_list->setFrameStyle(QFrame::NoFrame);
+    m_list->setTextElideMode(Qt::ElideMiddle);
+
+    layout->addWidget(m_input);
+    layout->addWidget(m_list);
+
+    connect(m_input, &QLineEdit::textChanged, this, &QuickOpen::updateResults);
+    connect(m_input, &QLineEdit::returnPressed, this, &QuickOpen::acceptCurrent);
+    connect(m_list, &QListWidget::itemActivated, this, &QuickOpen::acceptCurrent);
+    connect(m_index, &PathIndex::ready, this, [this]() {
+        resetRefinement();
+        if (isVisible())
+        {
+            updateResults();
+        }
+    });
+    connect(&Theme::instance(), &Theme::themeChanged, this, &QuickOpen::applyTheme);
+
+    applyTheme();
+}
+
+void QuickOpen::setRootPath(const QString &rootPath)
+{
+    resetRefinement();
+    m_index->setRootPath(rootPath);
+}
+
+void QuickOpen::refreshIndex()
+{
+    m_index->refresh();
+}
+
+void QuickOpen::popup()
+{
+    QWidget *host = parentWidget();
+    if (host)
+    {
+        int width = qMin(600, host->width() - 40);
+        resize(width, 360);
+        move((host->width() - width) / 2, 40);
+    }
+
+    show();
+    raise();
+    m_input->setFocus();
+    m_input->selectAll();
+    updateResults();
+}
+
+void QuickOpen::resetRefinement()
+{
+    m_lastQuery.clear();
+    m_lastMatched.clear();
+}
+
+void QuickOpen::updateResults()
+{
+    m_list->clear();
+
+    QString query = m_input->text().trimmed();
+    if (!m_index->isReady())
+    {
+        m_list->addItem(m_index->rootPath().isEmpty() ? "Open a folder to search files" : "Indexing files...");
+        return;
+    }
+    if (query.isEmpty())
+    {
+        resetRefinement();
+        return;
+    }
+
+    //* A longer query can only match a subset of what the shorter one matched *//
+    bool refine = !m_lastQuery.isEmpty() && query.startsWith(m_lastQuery)
+                  && m_lastGeneration == m_index->generation();
+
+    std::vector<quint32> matched;
+    QVector<PathMatch> results = m_index->match(query, MaxResults, refine ? &m_lastMatched : nullptr, matched);
+    m_lastMatched.swap(matched);
+    m_lastQuery = query;
+    m_lastGeneration = m_index->generation();
+
+    for (const PathMatch &match : results)
+    {
+        QString relative = m_index->relativePath(match.id);
+        int slash = relative.lastIndexOf('/');
+        QString name = relative.mid(slash + 1);
+        QString dir = slash > 0 ? relative.left(slash) : QString();
+
+        QListWidgetItem *item = new QListWidgetItem(dir.isEmpty() ? name : name + "   " + dir, m_list);
+        item->setData(Qt::UserRole, m_index->absolutePath(match.id));
+        item->setToolTip(relative);
+    }
+
+    if (m_list->count() > 0)
+    {
+        m_list->setCurrentRow(0);
+    }
+}
+
+void QuickOpen::acceptCurrent()
+{
+    QListWidgetItem *item = m_list->currentItem();
+    QString filePath = item ? item->data(Qt::UserRole).toString() : QString();
+    if (filePath.isEmpty())
+    {
+        return;
+    }
+
+    hide();
+    emit fileSelected(filePath);
+}
+
+bool QuickOpen::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == m_input && event->type() == QEvent::KeyPress)
+    {
+        QKeyEvent *keyEvent = static_cast<QKeyEvent *>(event);
+        switch (keyEvent->key())
+        {
+        case Qt::Key_Escape:
+            hide();
+            return true;
+        case Qt::Key_Down:
+            m_list->setCurrentRow(qMin(m_list->currentRow() + 1, m_list->count() - 1));
+            return true;
+        case Qt::Key_Up:
+            m_list->setCurrentRow(qMax(m_list->currentRow() - 1, 0));
+            return true;
+        default:
+            break;
+        }
+    }
+    else if (watched == m_input && event->type() == QEvent::FocusOut)
+    {
+        hide();
+    }
+    return QFrame::eventFilter(watched, event);
+}
+
+void QuickOpen::applyTheme()
+{
+    Theme &theme = Theme::instance();
+    StyleHelper &styleHelper = StyleHelper::instance();
+
+    QColor bgColor = theme.getColor("editor.background");
+    QColor fgColor = theme.getColor("editor.foreground");
+    QColor selectionBg = theme.getColor("explorer.selectionBackground");
+    QColor selectionFg = theme.getColor("explorer.selectionForeground");
+    QColor hoverBg = theme.getColor("explorer.hoverBackground");
+    QColor primaryColor = theme.getColor("primary");
+    QFont explorerFont = theme.getFont("explorer");
+
+    setStyleSheet(styleHelper.getSearchPanelStyle(bgColor, fgColor, selectionBg, selectionFg,
+                                                  hoverBg, primaryColor, explorerFont)
+                  + QString("QFrame#QuickOpen { border: 1px solid %1; }").arg(hoverBg.name()));
+}
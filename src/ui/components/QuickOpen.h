@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QFrame>
+#include <vector>
+
+class QLineEdit;
+class QListWidget;
+class PathIndex;
+
+/*
+ * Ctrl+P "Go to File" palette.
+ *
+ * Matches the query against a PathIndex of the opened folder and lists the
+ * best MaxResults files. When the query only grew since the last keystroke,
+ * only the files that matched the shorter query are scored again.
+ */
+class QuickOpen : public QFrame
+{
+    Q_OBJECT
+public:
+    explicit QuickOpen(QWidget *parent = nullptr);
+
+    void setRootPath(const QString &rootPath);
+    void refreshIndex();
+    void popup();
+
+    static constexpr int MaxResults = 50;
+
+signals:
+    void fileSelected(const QString &filePath);
+
+public slots:
+    void applyTheme();
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    void updateResults();
+    void acceptCurrent();
+
+private:
+    void resetRefinement();
+
+    QLineEdit *m_input;
+    QListWidget *m_list;
+    PathIndex *m_index;
+
+    QString m_lastQuery;
+    std::vector<quint32> m_lastMatched;
+    quint64 m_lastGeneration;
+};
@@ -3,7 +3,6 @@
 #include <QApplication>
 #include <QFileDialog>
 #include <QMessageBox>
-#include <QTabWidget>
 #include <QKeySequence>
 #include <QFile>
 #include <QTextStream>
@@ -17,6 +16,7 @@ FileMenu::FileMenu(QWidget *parent) : QMenu("File", parent)
     // Create actions
     newFileAction = new QAction("New", this);
     openFileAction = new QAction("Open", this);
+    quickOpenAction = new QAction("Go to File...", this);
     saveFileAction = new QAction("Save", this);
     saveAsFileAction = new QAction("Save As", this);
     exitApplicationAction = new QAction("Exit", this);
@@ -24,6 +24,7 @@ FileMenu::FileMenu(QWidget *parent) : QMenu("File", parent)
     // Set shortcuts
     newFileAction->setShortcut(QKeySequence::New);
     openFileAction->setShortcut(QKeySequence::Open);
+    quickOpenAction->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_P));
     saveFileAction->setShortcut(QKeySequence::Save);
     saveAsFileAction->setShortcut(QKeySequence::SaveAs);
     exitApplicationAction->setShortcut(QKeySequence::Quit);
@@ -31,6 +32,7 @@ FileMenu::FileMenu(QWidget *parent) : QMenu("File", parent)
     // Connect actions to slots
     connect(newFileAction, &QAction::triggered, this, &FileMenu::newFile);
     connect(openFileAction, &QAction::triggered, this, &FileMenu::openFile);
+    connect(quickOpenAction, &QAction::triggered, this, &FileMenu::quickOpen);
     connect(saveFileAction, &QAction::triggered, this, &FileMenu::saveFile);
     connect(saveAsFileAction, &QAction::triggered, this, &FileMenu::saveAsFile);
     connect(exitApplicationAction, &QAction::triggered, this, &FileMenu::exitApplication);
@@ -38,6 +40,7 @@ FileMenu::FileMenu(QWidget *parent) : QMenu("File", parent)
     // set status tip for actions
     newFileAction->setStatusTip("Create a new file");
     openFileAction->setStatusTip("Open an existing file");
+    quickOpenAction->setStatusTip("Open a file of the current folder by name");
     saveFileAction->setStatusTip("Save the current file");
     saveAsFileAction->setStatusTip("Save the current file with a new name");
     exitApplicationAction->setStatusTip("Exit the application");
@@ -46,6 +49,7 @@ FileMenu::FileMenu(QWidget *parent) : QMenu("File", parent)
     addAction(newFileAction);
     addSeparator();
     addAction(openFileAction);
+    addAction(quickOpenAction);
     addSeparator();
     addAction(saveFileAction);
     addSeparator();
@@ -69,6 +73,14 @@ void FileMenu::openFile()
     }
 }
 
+void FileMenu::quickOpen()
+{
+    if (mainWindow)
+    {
+        mainWindow->showQuickOpen();
+    }
+}
+
 /*
  * Sets the main window pointer for the FileMenu to interact with the main application window.
  * This allows the FileMenu to access and manipulate elements of the main window, such as
@@ -90,23 +102,14 @@ void FileMenu::saveFile()
         VOLT_INFO("Main window pointer is null in FileMenu::saveFile");
         return;
     }
-    QTabWidget *tabWidget = mainWindow->findChild<QTabWidget *>();
-    if (!tabWidget || tabWidget->count() == 0)
+    CodeEditor *editor = mainWindow->currentEditor();
+    if (!editor)
     {
         QMessageBox::warning(this, tr("Save File"), tr("No file is currently open to save."));
         return;
     }
 
-    int currentIndex = tabWidget->currentIndex();
-    QWidget *widget = tabWidget->widget(currentIndex);
-
-    QString currentPath;
-    if (tabWidget->tabBar())
-    {
-        QVariant data = tabWidget->tabBar()->tabData(currentIndex);
-        currentPath = data.toString();
-    }
-
+    QString currentPath = mainWindow->documentRegistry().pathOf(editor);
     if (currentPath.isEmpty())
     {
         // No file path associated, prompt Save As
@@ -114,18 +117,6 @@ void FileMenu::saveFile()
         return;
     }
 
-    CodeEditor *editor = nullptr;
-    if (widget)
-    {
-        editor = widget->findChild<CodeEditor *>();
-    }
-
-    if (!editor)
-    {
-        VOLT_INFO("No CodeEditor found in the current tab during Save operation.");
-        return;
-    }
-
     QString fileContent = editor->text();
 
     /*
@@ -133,8 +124,9 @@ void FileMenu::saveFile()
      * If the file cannot be opened for writing, an error message is displayed
      * to the user and an error is logged.
      */
+    //? No newline translation, the document already holds the file's own line endings
     QFile file(currentPath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    if (!file.open(QIODevice::WriteOnly))
     {
         QString errorMsg = QString("Failed to save file: %1\nError: %2").arg(currentPath, file.errorString());
         QMessageBox::critical(this, "Error", errorMsg);
@@ -145,10 +137,12 @@ void FileMenu::saveFile()
     QTextStream out(&file);
     out << fileContent;
     file.close();
+    mainWindow->documentRegistry().refresh(editor);
     
     //* Mark the editor as saved
     editor->markAsSaved();
     VOLT_INFO_F("File saved successfully: %1", currentPath);
+    emit fileSaved(currentPath);
 }
 
 /*
@@ -164,41 +158,20 @@ void FileMenu::saveAsFile()
         VOLT_INFO("Main window pointer is null in FileMenu::saveAsFile");
         return;
     }
-    QTabWidget *tabWidget = mainWindow->findChild<QTabWidget *>();
-    if (!tabWidget || tabWidget->count() == 0)
+    CodeEditor *editor = mainWindow->currentEditor();
+    if (!editor)
     {
         QMessageBox::warning(this, tr("Save File As"), tr("No file is currently open to save."));
         return;
     }
 
-    int currentIndex = tabWidget->currentIndex();
-    QWidget *widget = tabWidget->widget(currentIndex);
-
-    QString currentPath;
-    if (tabWidget->tabBar())
-    {
-        QVariant data = tabWidget->tabBar()->tabData(currentIndex);
-        currentPath = data.toString();
-    }
-
+    QString currentPath = mainWindow->documentRegistry().pathOf(editor);
     QString fileName = QFileDialog::getSaveFileName(this, tr("Save File As"), currentPath, tr("Text Files (*.txt);;All Files (*);;Cpp Files (*.cpp *.h)"));
     if (fileName.isEmpty())
     {
         return;
     }
 
-    CodeEditor *editor = nullptr;
-    if (widget)
-    {
-        editor = widget->findChild<CodeEditor *>();
-    }
-
-    if (!editor)
-    {
-        VOLT_INFO("No CodeEditor found in the current tab during Save As operation.");
-        return;
-    }
-
     QString fileContent = editor->text();
 
     /*
@@ -206,8 +179,9 @@ void FileMenu::saveAsFile()
      * If the file cannot be opened for writing, an error message is displayed
      * to the user and an error is logged.
      */
+    //? No newline translation, the document already holds the file's own line endings
     QFile file(fileName);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    if (!file.open(QIODevice::WriteOnly))
     {
         QString errorMsg = QString("Failed to save file: %1\nError: %2").arg(fileName, file.errorString());
         QMessageBox::critical(this, "Error", errorMsg);
@@ -220,15 +194,15 @@ void FileMenu::saveAsFile()
     file.close();
 
     /*
-     * Update the tab title and data to reflect the new file name and path.
+     * The document now lives at the new path; the main window updates the
+     * tab title and tooltip from the registry.
      */
-    QFileInfo fileInfo(fileName);
-    tabWidget->tabBar()->setTabText(currentIndex, fileInfo.fileName());
-    tabWidget->tabBar()->setTabData(currentIndex, fileName);
+    mainWindow->documentRegistry().setPath(editor, fileName);
     
     // Mark the editor as saved (removes asterisk from tab title)
     editor->markAsSaved();
     VOLT_INFO_F("File saved as: %1", fileName);
+    emit fileSaved(fileName);
 }
 
 void FileMenu::exitApplication()
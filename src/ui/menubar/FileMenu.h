@@ -13,9 +13,13 @@ public:
     void setMainWindow(MainWindow *mw);
     ~FileMenu() = default;
 
+signals:
+    void fileSaved(const QString &filePath);
+
 private slots:
     void newFile();
     void openFile();
+    void quickOpen();
     void saveFile();
     void saveAsFile();
     void exitApplication();
@@ -23,6 +27,7 @@ private slots:
 private:
     QAction *newFileAction;
     QAction *openFileAction;
+    QAction *quickOpenAction;
     QAction *saveFileAction;
     QAction *saveAsFileAction;
     QAction *exitApplicationAction;
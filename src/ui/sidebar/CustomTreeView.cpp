@@ -1,22 +1,21 @@
 #include "CustomTreeView.h"
 #include "../../themes/Theme.h"
 #include "../../logging/VoltLogger.h"
-#include <QFileSystemModel>
-#include <QFileInfo>
+#include "../../logging/PaintStats.h"
+#include "ProjectTreeModel.h"
+#include "../utils/IconAtlas.h"
 #include <QStyleOptionViewItem>
 
 FileItemDelegate::FileItemDelegate(QObject *parent)
     : QStyledItemDelegate(parent),
-      m_iconFont("icons-carbon")
+      m_themeGeneration(~quint64(0))
 {
-    m_iconFont.setPixelSize(16);
 }
 
 void FileItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
                              const QModelIndex &index) const
 {
-    QFileSystemModel *model = static_cast<QFileSystemModel *>(const_cast<QAbstractItemModel *>(index.model()));
-    if (!model)
+    if (!index.isValid())
     {
         QStyledItemDelegate::paint(painter, option, index);
         return;
@@ -40,27 +39,22 @@ void FileItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &opti
         }
     }
 
-    QString fileName = model->fileName(index);
-    bool isDir = model->isDir(index);
+    QString fileName = index.data(Qt::DisplayRole).toString();
+    bool isDir = index.data(ProjectTreeModel::IsDirRole).toBool();
+
+    updateThemeCache();
 
     if ((option.state & QStyle::State_Selected))
     {
-        QColor selection = Theme::instance().getColor("hoverColor");
-
-        painter->fillRect(fullRect, selection);
+        painter->fillRect(fullRect, m_hoverColor);
     }
 
     if ((option.state & QStyle::State_MouseOver) && !(option.state & QStyle::State_Selected))
     {
-        QColor hover = Theme::instance().getColor("hoverColor");
-
-        painter->fillRect(fullRect, hover);
+        painter->fillRect(fullRect, m_hoverColor);
     }
 
-    painter->setFont(m_iconFont);
-
-    QColor iconColor = isDir ? Theme::instance().getColor("editor.foreground") : getFileIconColor(fileName);
-    painter->setPen(iconColor);
+    QColor iconColor = isDir ? m_foregroundColor : getFileIconColor(fileName);
 
     QChar iconChar = isDir ? getFolderIcon(option.state & QStyle::State_Open) : getFileIcon(fileName);
 
@@ -72,7 +66,8 @@ void FileItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &opti
     }
     QRect iconRect(iconLeft, itemRect.top() + 3, iconSize, itemRect.height() - 6);
 
-    painter->drawText(iconRect, Qt::AlignCenter, iconChar);
+    // Glyphs are blitted from the shared atlas instead of being shaped per row
+    IconAtlas::instance().draw(painter, iconRect, iconChar, iconColor, iconSize);
 
     QRect textRect = fullRect;
     textRect.setLeft(iconRect.right() + 6);
@@ -92,18 +87,27 @@ QSize FileItemDelegate::sizeHint(const QStyleOptionViewItem &option, const QMode
 
 QChar FileItemDelegate::getFileIcon(const QString &fileName) const
 {
-    QString extension = QFileInfo(fileName).suffix().toLower();
+    int dot = fileName.lastIndexOf('.');
+    QString extension = dot >= 0 ? fileName.mid(dot + 1).toLower() : QString();
+
+    // Glyphs are resolved once per extension, not once per painted row
+    auto cached = m_fileIconCache.constFind(extension);
+    if (cached != m_fileIconCache.constEnd())
+    {
+        return cached.value();
+    }
+
     QChar iconChar;
 
     //TODO@ADITYAbasude: Add more file types and icons
     if (extension == "ini" || extension == "conf" || extension == "cfg" ||
              extension == "toml" || extension == "env")
     {
-        iconChar = Theme::instance().getCarbonIconChar("settings");
+        iconChar = Theme::instance().getCarbonIconChar(u"settings");
     }
     else
     {
-        iconChar = Theme::instance().getCarbonIconChar("document-blank");
+        iconChar = Theme::instance().getCarbonIconChar(u"document-blank");
     }
 
     if (iconChar.isNull())
@@ -111,28 +115,37 @@ QChar FileItemDelegate::getFileIcon(const QString &fileName) const
         iconChar = QChar(0xe095);
     }
 
+    m_fileIconCache.insert(extension, iconChar);
     return iconChar;
 }
 
 QChar FileItemDelegate::getFolderIcon(bool isExpanded) const
 {
-    if (isExpanded)
-    {
-        return Theme::instance().getCarbonIconChar("chevron-down");
-    }
-    else
-    {
-        return Theme::instance().getCarbonIconChar("chevron-right");
-    }
+    static const QChar expandedIcon = Theme::instance().getCarbonIconChar(u"chevron-down");
+    static const QChar collapsedIcon = Theme::instance().getCarbonIconChar(u"chevron-right");
+    return isExpanded ? expandedIcon : collapsedIcon;
 }
 
 QColor FileItemDelegate::getFileIconColor(const QString &fileName) const
 {
-    QString extension = QFileInfo(fileName).suffix().toLower();
-    Theme &theme = Theme::instance();
+    Q_UNUSED(fileName)
 
     //TODO@ADITYAbasude: Add more file types and colors
-    return theme.getColor("editor.foreground");
+    return m_foregroundColor;
+}
+
+// Re-resolves the theme colors used per row only after a theme change
+void FileItemDelegate::updateThemeCache() const
+{
+    Theme &theme = Theme::instance();
+    if (m_themeGeneration == theme.generation())
+    {
+        return;
+    }
+
+    m_hoverColor = theme.getColor(ThemeColor::HoverColor);
+    m_foregroundColor = theme.getColor(ThemeColor::EditorForeground);
+    m_themeGeneration = theme.generation();
 }
 
 CustomTreeView::CustomTreeView(QWidget *parent)
@@ -143,6 +156,12 @@ CustomTreeView::CustomTreeView(QWidget *parent)
     setItemDelegate(m_itemDelegate);
 }
 
+void CustomTreeView::paintEvent(QPaintEvent *event)
+{
+    PaintTimer paintTimer(PaintStats::TreeViewPaint);
+    QTreeView::paintEvent(event);
+}
+
 void CustomTreeView::drawRow(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
 {
     QTreeView::drawRow(painter, option, index);
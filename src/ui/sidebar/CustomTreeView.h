@@ -3,8 +3,8 @@
 #include <QPainter>
 #include <QFont>
 #include <QColor>
+#include <QHash>
 #include <QStyledItemDelegate>
-#include <QFileSystemModel>
 
 class FileItemDelegate : public QStyledItemDelegate {
     Q_OBJECT
@@ -21,7 +21,11 @@ private:
     QChar getFileIcon(const QString &fileName) const;
     QChar getFolderIcon(bool isExpanded) const;
     QColor getFileIconColor(const QString &fileName) const;
-    mutable QFont m_iconFont;
+    void updateThemeCache() const;
+    mutable QHash<QString, QChar> m_fileIconCache;
+    mutable QColor m_hoverColor;
+    mutable QColor m_foregroundColor;
+    mutable quint64 m_themeGeneration;
 };
 
 class CustomTreeView : public QTreeView {
@@ -30,6 +34,7 @@ public:
     explicit CustomTreeView(QWidget *parent = nullptr);
     
 protected:
+    void paintEvent(QPaintEvent *event) override;
     void drawBranches(QPainter *painter, const QRect &rect, const QModelIndex &index) const override;
     void drawRow(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
 private:
@@ -0,0 +1,517 @@
+#include "ProjectTreeModel.h"
+#include "../../logging/VoltLogger.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QTimer>
+
+#include <algorithm>
+
+#ifdef Q_OS_UNIX
+#include <dirent.h>
+#else
+#include <QDirIterator>
+#endif
+
+namespace {
+
+//* Folders first, then case-insensitive by name; computed once when the entry is listed *//
+QString makeSortKey(const QString &name, bool isDir)
+{
+    return QLatin1Char(isDir ? '0' : '1') + name.toCaseFolded();
+}
+
+//* Names that only differ in case share a key, the raw name keeps the order total *//
+int compareEntries(const QString &keyA, const QString &nameA, const QString &keyB, const QString &nameB)
+{
+    int result = QString::compare(keyA, keyB);
+    return result != 0 ? result : QString::compare(nameA, nameB);
+}
+
+/*
+ * Lists one directory without following into it. On Unix the entry type
+ * comes straight from readdir, only symlinks and filesystems that do not
+ * report a type need a stat. Hidden entries are skipped like the old
+ * QFileSystemModel filter did.
+ */
+QVector<ProjectTreeModel::Entry> listDirectory(const QString &path)
+{
+    QVector<ProjectTreeModel::Entry> entries;
+
+#ifdef Q_OS_UNIX
+    DIR *dir = opendir(QFile::encodeName(path).constData());
+    if (!dir)
+    {
+        return entries;
+    }
+
+    while (dirent *entry = readdir(dir))
+    {
+        if (entry->d_name[0] == '.')
+        {
+            continue;
+        }
+
+        QString name = QFile::decodeName(entry->d_name);
+        bool isDir = entry->d_type == DT_DIR;
+        if (entry->d_type == DT_LNK || entry->d_type == DT_UNKNOWN)
+        {
+            isDir = QFileInfo(path + QLatin1Char('/') + name).isDir();
+        }
+        entries.append({name, makeSortKey(name, isDir), isDir});
+    }
+    closedir(dir);
+#else
+    //? FindFirstFile already returns the attributes, QDirIterator caches them
+    QDirIterator it(path, QDir::AllEntries | QDir::NoDotAndDotDot);
+    while (it.hasNext())
+    {
+        it.next();
+        QString name = it.fileName();
+        bool isDir = it.fileInfo().isDir();
+        entries.append({name, makeSortKey(name, isDir), isDir});
+    }
+#endif
+
+    std::sort(entries.begin(), entries.end(),
+              [](const ProjectTreeModel::Entry &a, const ProjectTreeModel::Entry &b) {
+                  return compareEntries(a.sortKey, a.name, b.sortKey, b.name) < 0;
+              });
+    return entries;
+}
+
+}
+
+ProjectTreeModel::ProjectTreeModel(QObject *parent)
+    : QAbstractItemModel(parent), m_requestCounter(0)
+{
+    m_pool.setMaxThreadCount(2);
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &ProjectTreeModel::onDirectoryChanged);
+}
+
+ProjectTreeModel::~ProjectTreeModel()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+void ProjectTreeModel::setRootPath(const QString &rootPath)
+{
+    beginResetModel();
+    if (!m_watcher.directories().isEmpty())
+    {
+        m_watcher.removePaths(m_watcher.directories());
+    }
+    m_requests.clear();
+    m_rootPath = rootPath;
+    m_root.reset();
+    if (!rootPath.isEmpty())
+    {
+        m_root = std::make_unique<Node>();
+        m_root->name = rootPath;
+        m_root->isDir = true;
+    }
+    endResetModel();
+
+    if (m_root)
+    {
+        m_root->watched = m_watcher.addPath(rootPath);
+        requestListing(m_root.get());
+    }
+}
+
+QString ProjectTreeModel::filePath(const QModelIndex &index) const
+{
+    Node *node = nodeFromIndex(index);
+    return node ? pathOfNode(node) : QString();
+}
+
+bool ProjectTreeModel::isDir(const QModelIndex &index) const
+{
+    Node *node = nodeFromIndex(index);
+    return node && node->isDir;
+}
+
+void ProjectTreeModel::setWatched(const QModelIndex &index, bool watched)
+{
+    Node *node = nodeFromIndex(index);
+    if (!node || !node->isDir || node->watched == watched)
+    {
+        return;
+    }
+
+    QString path = pathOfNode(node);
+    if (watched)
+    {
+        node->watched = m_watcher.addPath(path);
+    }
+    else
+    {
+        m_watcher.removePath(path);
+        node->watched = false;
+    }
+}
+
+void ProjectTreeModel::refreshDirectory(const QString &path)
+{
+    Node *node = nodeForPath(path);
+    if (node && node->state != Node::Unloaded)
+    {
+        requestListing(node);
+    }
+}
+
+void ProjectTreeModel::onDirectoryChanged(const QString &path)
+{
+    refreshDirectory(path);
+}
+
+QModelIndex ProjectTreeModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (!hasIndex(row, column, parent))
+    {
+        return QModelIndex();
+    }
+
+    Node *parentNode = parent.isValid() ? nodeFromIndex(parent) : m_root.get();
+    return createIndex(row, column, parentNode->children[size_t(row)].get());
+}
+
+QModelIndex ProjectTreeModel::parent(const QModelIndex &child) const
+{
+    Node *node = nodeFromIndex(child);
+    if (!node)
+    {
+        return QModelIndex();
+    }
+    return indexFromNode(node->parent);
+}
+
+int ProjectTreeModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.column() > 0)
+    {
+        return 0;
+    }
+
+    Node *node = parent.isValid() ? nodeFromIndex(parent) : m_root.get();
+    return node ? int(node->children.size()) : 0;
+}
+
+int ProjectTreeModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent)
+    return 1;
+}
+
+QVariant ProjectTreeModel::data(const QModelIndex &index, int role) const
+{
+    Node *node = nodeFromIndex(index);
+    if (!node)
+    {
+        return QVariant();
+    }
+
+    switch (role)
+    {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+        return node->name;
+    case Qt::ToolTipRole:
+    case FilePathRole:
+        return pathOfNode(node);
+    case IsDirRole:
+        return node->isDir;
+    default:
+        return QVariant();
+    }
+}
+
+bool ProjectTreeModel::hasChildren(const QModelIndex &parent) const
+{
+    Node *node = parent.isValid() ? nodeFromIndex(parent) : m_root.get();
+    if (!node || !node->isDir)
+    {
+        return false;
+    }
+
+    //* Unlisted folders show an arrow until listing proves them empty *//
+    return node->state != Node::Loaded || !node->children.empty();
+}
+
+bool ProjectTreeModel::canFetchMore(const QModelIndex &parent) const
+{
+    Node *node = parent.isValid() ? nodeFromIndex(parent) : m_root.get();
+    return node && node->isDir && node->state == Node::Unloaded;
+}
+
+void ProjectTreeModel::fetchMore(const QModelIndex &parent)
+{
+    Node *node = parent.isValid() ? nodeFromIndex(parent) : m_root.get();
+    if (node && node->isDir && node->state == Node::Unloaded)
+    {
+        requestListing(node);
+    }
+}
+
+ProjectTreeModel::Node *ProjectTreeModel::nodeFromIndex(const QModelIndex &index) const
+{
+    return index.isValid() ? static_cast<Node *>(index.internalPointer()) : nullptr;
+}
+
+QModelIndex ProjectTreeModel::indexFromNode(Node *node) const
+{
+    if (!node || node == m_root.get())
+    {
+        return QModelIndex();
+    }
+    return createIndex(node->row, 0, node);
+}
+
+QString ProjectTreeModel::pathOfNode(const Node *node) const
+{
+    if (node == m_root.get())
+    {
+        return m_rootPath;
+    }
+    return pathOfNode(node->parent) + QLatin1Char('/') + node->name;
+}
+
+ProjectTreeModel::Node *ProjectTreeModel::nodeForPath(const QString &path) const
+{
+    if (!m_root || !path.startsWith(m_rootPath))
+    {
+        return nullptr;
+    }
+    if (path.size() == m_rootPath.size())
+    {
+        return m_root.get();
+    }
+    if (path.at(m_rootPath.size()) != QLatin1Char('/'))
+    {
+        return nullptr;
+    }
+
+    //* Every component on the way is a folder, so its sort key is known and the lookup is a binary search *//
+    Node *node = m_root.get();
+    const QStringList parts = path.mid(m_rootPath.size() + 1).split(QLatin1Char('/'), Qt::SkipEmptyParts);
+    for (const QString &part : parts)
+    {
+        QString key = makeSortKey(part, true);
+        auto it = std::lower_bound(node->children.begin(), node->children.end(), part,
+                                   [&key](const std::unique_ptr<Node> &child, const QString &name) {
+                                       return compareEntries(child->sortKey, child->name, key, name) < 0;
+                                   });
+        if (it == node->children.end() || (*it)->name != part)
+        {
+            return nullptr;
+        }
+        node = it->get();
+    }
+    return node;
+}
+
+/*
+ * Lists the node's directory on the pool. A newer request for the same node
+ * supersedes an older one, whose result is then dropped by its id.
+ */
+void ProjectTreeModel::requestListing(Node *node)
+{
+    if (node->request != 0)
+    {
+        m_requests.remove(node->request);
+    }
+    if (node->state == Node::Unloaded)
+    {
+        node->state = Node::Loading;
+    }
+
+    quint64 request = ++m_requestCounter;
+    node->request = request;
+    m_requests.insert(request, node);
+
+    QString path = pathOfNode(node);
+    m_pool.start([this, request, path]() {
+        QElapsedTimer timer;
+        timer.start();
+        QVector<Entry> entries = listDirectory(path);
+        if (entries.size() >= InsertBatchSize)
+        {
+            VOLT_DEBUG_F3("ProjectTreeModel: listed %1 entries of %2 in %3 ms", QString::number(entries.size()),
+                          path, QString::number(timer.elapsed()));
+        }
+
+        QMetaObject::invokeMethod(this, [this, request, entries]() { onListed(request, entries); },
+                                  Qt::QueuedConnection);
+    });
+}
+
+void ProjectTreeModel::onListed(quint64 request, const QVector<Entry> &entries)
+{
+    Node *node = m_requests.value(request, nullptr);
+    if (!node)
+    {
+        return;
+    }
+
+    if (node->state == Node::Loading && node->children.empty())
+    {
+        insertBatch(node, request, entries, 0);
+        return;
+    }
+
+    m_requests.remove(request);
+    node->request = 0;
+    mergeListing(node, entries);
+    node->state = Node::Loaded;
+}
+
+/*
+ * First listing of a directory: rows are appended InsertBatchSize at a time,
+ * yielding to the event loop in between so painting and input keep going
+ * while a very large folder fills in.
+ */
+void ProjectTreeModel::insertBatch(Node *node, quint64 request, const QVector<Entry> &entries, int from)
+{
+    int to = qMin(from + InsertBatchSize, int(entries.size()));
+    if (to > from)
+    {
+        beginInsertRows(indexFromNode(node), from, to - 1);
+        node->children.reserve(size_t(entries.size()));
+        for (int i = from; i < to; ++i)
+        {
+            node->children.push_back(makeNode(entries[i], node, i));
+        }
+        endInsertRows();
+    }
+
+    if (to < entries.size())
+    {
+        QTimer::singleShot(0, this, [this, request, entries, to]() {
+            Node *pending = m_requests.value(request, nullptr);
+            if (pending)
+            {
+                insertBatch(pending, request, entries, to);
+            }
+        });
+        return;
+    }
+
+    m_requests.remove(request);
+    node->request = 0;
+    node->state = Node::Loaded;
+}
+
+/*
+ * Relisting of a loaded directory. Both sides are sorted by the same key, so
+ * one pass finds the runs of vanished and new entries. Entries that stayed
+ * keep their nodes, and with them their expansion state and loaded children.
+ */
+void ProjectTreeModel::mergeListing(Node *node, const QVector<Entry> &entries)
+{
+    QModelIndex parentIndex = indexFromNode(node);
+    std::vector<std::unique_ptr<Node>> &children = node->children;
+
+    auto compareAt = [&](size_t row, int i) {
+        if (row >= children.size())
+        {
+            return 1;
+        }
+        if (i >= entries.size())
+        {
+            return -1;
+        }
+        return compareEntries(children[row]->sortKey, children[row]->name, entries[i].sortKey, entries[i].name);
+    };
+
+    size_t row = 0;
+    int i = 0;
+    while (row < children.size() || i < entries.size())
+    {
+        int order = compareAt(row, i);
+        if (order == 0)
+        {
+            ++row;
+            ++i;
+        }
+        else if (order < 0)
+        {
+            size_t last = row;
+            while (last + 1 < children.size() && compareAt(last + 1, i) < 0)
+            {
+                ++last;
+            }
+
+            beginRemoveRows(parentIndex, int(row), int(last));
+            for (size_t r = row; r <= last; ++r)
+            {
+                releaseSubtree(children[r].get());
+            }
+            children.erase(children.begin() + std::ptrdiff_t(row), children.begin() + std::ptrdiff_t(last) + 1);
+            renumber(node, int(row));
+            endRemoveRows();
+        }
+        else
+        {
+            int end = i + 1;
+            while (end < entries.size() && compareAt(row, end) > 0)
+            {
+                ++end;
+            }
+
+            beginInsertRows(parentIndex, int(row), int(row) + end - i - 1);
+            std::vector<std::unique_ptr<Node>> added;
+            added.reserve(size_t(end - i));
+            for (int e = i; e < end; ++e)
+            {
+                added.push_back(makeNode(entries[e], node, 0));
+            }
+            children.insert(children.begin() + std::ptrdiff_t(row), std::make_move_iterator(added.begin()),
+                            std::make_move_iterator(added.end()));
+            renumber(node, int(row));
+            endInsertRows();
+
+            row += size_t(end - i);
+            i = end;
+        }
+    }
+}
+
+std::unique_ptr<ProjectTreeModel::Node> ProjectTreeModel::makeNode(const Entry &entry, Node *parent, int row)
+{
+    auto node = std::make_unique<Node>();
+    node->name = entry.name;
+    node->sortKey = entry.sortKey;
+    node->isDir = entry.isDir;
+    node->parent = parent;
+    node->row = row;
+    return node;
+}
+
+void ProjectTreeModel::renumber(Node *node, int from)
+{
+    for (size_t r = size_t(from); r < node->children.size(); ++r)
+    {
+        node->children[r]->row = int(r);
+    }
+}
+
+//* Drops pending listings and watches of a subtree that is about to be deleted *//
+void ProjectTreeModel::releaseSubtree(Node *node)
+{
+    if (node->request != 0)
+    {
+        m_requests.remove(node->request);
+        node->request = 0;
+    }
+    if (node->watched)
+    {
+        m_watcher.removePath(pathOfNode(node));
+        node->watched = false;
+    }
+    for (const std::unique_ptr<Node> &child : node->children)
+    {
+        releaseSubtree(child.get());
+    }
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <QAbstractItemModel>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+#include <memory>
+#include <vector>
+
+/*
+ * Tree model of a project folder, replacing QFileSystemModel in the explorer.
+ *
+ * Directories are listed only when the view asks for them (fetchMore), on a
+ * worker thread, with readdir where available so no per-entry stat is needed.
+ * Entries are sorted on the worker by a key computed once per entry, folders
+ * first and then by case-folded name. Large directories are inserted into the
+ * model in batches so the view stays responsive while they arrive.
+ *
+ * Only the root and the directories expanded in the view are watched.
+ */
+class ProjectTreeModel : public QAbstractItemModel
+{
+    Q_OBJECT
+public:
+    enum Roles
+    {
+        FilePathRole = Qt::UserRole + 1,
+        IsDirRole
+    };
+
+    struct Entry
+    {
+        QString name;
+        QString sortKey;
+        bool isDir;
+    };
+
+    explicit ProjectTreeModel(QObject *parent = nullptr);
+    ~ProjectTreeModel();
+
+    void setRootPath(const QString &rootPath);
+    QString rootPath() const { return m_rootPath; }
+
+    QString filePath(const QModelIndex &index) const;
+    bool isDir(const QModelIndex &index) const;
+
+    // Watches an expanded directory for changes, unwatches it when collapsed
+    void setWatched(const QModelIndex &index, bool watched);
+    // Lists a directory again and merges the differences into the model
+    void refreshDirectory(const QString &path);
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+    //* Rows inserted per event loop pass when a big directory arrives *//
+    static constexpr int InsertBatchSize = 2000;
+
+private slots:
+    void onDirectoryChanged(const QString &path);
+
+private:
+    struct Node
+    {
+        enum State
+        {
+            Unloaded,
+            Loading,
+            Loaded
+        };
+
+        QString name;
+        QString sortKey;
+        bool isDir = false;
+        bool watched = false;
+        State state = Unloaded;
+        quint64 request = 0;
+        Node *parent = nullptr;
+        int row = 0;
+        std::vector<std::unique_ptr<Node>> children;
+    };
+
+    Node *nodeFromIndex(const QModelIndex &index) const;
+    QModelIndex indexFromNode(Node *node) const;
+    QString pathOfNode(const Node *node) const;
+    Node *nodeForPath(const QString &path) const;
+
+    void requestListing(Node *node);
+    void onListed(quint64 request, const QVector<Entry> &entries);
+    void insertBatch(Node *node, quint64 request, const QVector<Entry> &entries, int from);
+    void mergeListing(Node *node, const QVector<Entry> &entries);
+    std::unique_ptr<Node> makeNode(const Entry &entry, Node *parent, int row);
+    void renumber(Node *node, int from);
+    void releaseSubtree(Node *node);
+
+    QString m_rootPath;
+    std::unique_ptr<Node> m_root;
+    QHash<quint64, Node *> m_requests;
+    quint64 m_requestCounter;
+    QThreadPool m_pool;
+    QFileSystemWatcher m_watcher;
+};
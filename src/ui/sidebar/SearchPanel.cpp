@@ -0,0 +1,252 @@
+#include "SearchPanel.h"
+#include "../../themes/Theme.h"
+#include "../../styles/StyleHelper.h"
+#include "../../search/TrigramIndex.h"
+
+#include <QCheckBox>
+#include <QHBoxLayout>
+#include <QKeyEvent>
+#include <QLabel>
+#include <QLineEdit>
+#include <QListView>
+#include <QVBoxLayout>
+
+SearchResultModel::SearchResultModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int SearchResultModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_matches.size();
+}
+
+QVariant SearchResultModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_matches.size())
+    {
+        return QVariant();
+    }
+
+    const SearchMatch &match = m_matches.at(index.row());
+    switch (role)
+    {
+    case Qt::DisplayRole:
+        //* Built on demand, only the rows on screen are ever formatted *//
+        return QString("%1:%2  %3")
+            .arg(m_root.relativeFilePath(match.filePath))
+            .arg(match.line + 1)
+            .arg(match.preview.trimmed());
+    case Qt::ToolTipRole:
+        return match.filePath;
+    case FilePathRole:
+        return match.filePath;
+    case LineRole:
+        return match.line;
+    case ColumnRole:
+        return match.column;
+    default:
+        return QVariant();
+    }
+}
+
+void SearchResultModel::setRootPath(const QString &rootPath)
+{
+    m_root = QDir(rootPath);
+}
+
+void SearchResultModel::appendMatches(const QVector<SearchMatch> &matches)
+{
+    if (matches.isEmpty())
+    {
+        return;
+    }
+
+    int first = m_matches.size();
+    beginInsertRows(QModelIndex(), first, first + matches.size() - 1);
+    m_matches.append(matches);
+    endInsertRows();
+}
+
+void SearchResultModel::clear()
+{
+    beginResetModel();
+    m_matches.clear();
+    m_matches.squeeze();
+    endResetModel();
+}
+
+SearchPanel::SearchPanel(QWidget *parent)
+    : QWidget(parent),
+      m_queryEdit(new QLineEdit(this)),
+      m_caseCheck(new QCheckBox("Match Case", this)),
+      m_regexCheck(new QCheckBox("Regex", this)),
+      m_statusLabel(new QLabel(this)),
+      m_resultsView(new QListView(this)),
+      m_model(new SearchResultModel(this)),
+      m_search(new ProjectSearch(this)),
+      m_index(nullptr)
+{
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(8, 8, 8, 0);
+    layout->setSpacing(6);
+
+    m_queryEdit->setPlaceholderText("Search");
+    m_queryEdit->setClearButtonEnabled(true);
+    m_queryEdit->installEventFilter(this);
+
+    QHBoxLayout *optionsLayout = new QHBoxLayout();
+    optionsLayout->setContentsMargins(0, 0, 0, 0);
+    optionsLayout->addWidget(m_caseCheck);
+    optionsLayout->addWidget(m_regexCheck);
+    optionsLayout->addStretch();
+
+    m_statusLabel->setWordWrap(true);
+
+    //* Uniform rows and batched layout keep the view cheap no matter how many results stream in *//
+    m_resultsView->setModel(m_model);
+    m_resultsView->setUniformItemSizes(true);
+    m_resultsView->setLayoutMode(QListView::Batched);
+    m_resultsView->setBatchSize(200);
+    m_resultsView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_resultsView->setTextElideMode(Qt::ElideRight);
+    m_resultsView->setFrameStyle(QFrame::NoFrame);
+
+    layout->addWidget(m_queryEdit);
+    layout->addLayout(optionsLayout);
+    layout->addWidget(m_statusLabel);
+    layout->addWidget(m_resultsView, 1);
+
+    m_debounceTimer.setSingleShot(true);
+    m_debounceTimer.setInterval(300);
+
+    connect(&m_debounceTimer, &QTimer::timeout, this, &SearchPanel::startSearch);
+    connect(m_queryEdit, &QLineEdit::textChanged, this, [this]() { m_debounceTimer.start(); });
+    connect(m_queryEdit, &QLineEdit::returnPressed, this, &SearchPanel::startSearch);
+    connect(m_caseCheck, &QCheckBox::toggled, this, &SearchPanel::startSearch);
+    connect(m_regexCheck, &QCheckBox::toggled, this, &SearchPanel::startSearch);
+    connect(m_search, &ProjectSearch::matchesFound, this, &SearchPanel::onMatchesFound);
+    connect(m_search, &ProjectSearch::finished, this, &SearchPanel::onSearchFinished);
+    connect(m_resultsView, &QListView::activated, this, &SearchPanel::onResultActivated);
+    connect(&Theme::instance(), &Theme::themeChanged, this, &SearchPanel::applyTheme);
+
+    applyTheme();
+}
+
+void SearchPanel::setRootPath(const QString &rootPath)
+{
+    if (rootPath == m_rootPath)
+    {
+        return;
+    }
+
+    m_rootPath = rootPath;
+    m_model->setRootPath(rootPath);
+    if (!m_queryEdit->text().isEmpty())
+    {
+        startSearch();
+    }
+}
+
+void SearchPanel::focusQuery()
+{
+    m_queryEdit->setFocus();
+    m_queryEdit->selectAll();
+}
+
+void SearchPanel::startSearch()
+{
+    m_debounceTimer.stop();
+    m_search->cancel();
+    m_model->clear();
+
+    QString pattern = m_queryEdit->text();
+    if (pattern.isEmpty())
+    {
+        m_statusLabel->clear();
+        return;
+    }
+    if (m_rootPath.isEmpty())
+    {
+        m_statusLabel->setText("Open a folder to search in files.");
+        return;
+    }
+
+    SearchOptions options;
+    options.pattern = pattern;
+    options.caseSensitive = m_caseCheck->isChecked();
+    options.regularExpression = m_regexCheck->isChecked();
+
+    //? Regex searches always scan, the index only knows about literal trigrams
+    if (m_index && !options.regularExpression && m_index->rootPath() == m_rootPath
+        && m_index->candidates(pattern, options.caseSensitive, options.files))
+    {
+        options.restrictToFiles = true;
+        if (options.files.isEmpty())
+        {
+            m_statusLabel->setText("No results");
+            return;
+        }
+    }
+
+    m_statusLabel->setText("Searching...");
+    m_search->start(m_rootPath, options);
+}
+
+void SearchPanel::onMatchesFound(const QVector<SearchMatch> &matches)
+{
+    m_model->appendMatches(matches);
+    m_statusLabel->setText(QString("Searching... %1 results").arg(m_model->rowCount()));
+}
+
+void SearchPanel::onSearchFinished(int matchCount, int fileCount, bool truncated)
+{
+    QString status = QString("%1 results in %2 files").arg(matchCount).arg(fileCount);
+    if (truncated)
+    {
+        status += " (limit reached, refine the search to see more)";
+    }
+    m_statusLabel->setText(status);
+}
+
+void SearchPanel::onResultActivated(const QModelIndex &index)
+{
+    if (!index.isValid())
+    {
+        return;
+    }
+
+    emit matchActivated(index.data(SearchResultModel::FilePathRole).toString(),
+                        index.data(SearchResultModel::LineRole).toInt(),
+                        index.data(SearchResultModel::ColumnRole).toInt());
+}
+
+bool SearchPanel::eventFilter(QObject *watched, QEvent *event)
+{
+    //* Escape stops a running search without clearing the query *//
+    if (watched == m_queryEdit && event->type() == QEvent::KeyPress
+        && static_cast<QKeyEvent *>(event)->key() == Qt::Key_Escape && m_search->isRunning())
+    {
+        m_search->cancel();
+        return true;
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
+void SearchPanel::applyTheme()
+{
+    Theme &theme = Theme::instance();
+    StyleHelper &styleHelper = StyleHelper::instance();
+
+    QColor bgColor = theme.getColor("editor.background");
+    QColor fgColor = theme.getColor("editor.foreground");
+    QColor selectionBg = theme.getColor("explorer.selectionBackground");
+    QColor selectionFg = theme.getColor("explorer.selectionForeground");
+    QColor hoverBg = theme.getColor("explorer.hoverBackground");
+    QColor primaryColor = theme.getColor("primary");
+    QFont explorerFont = theme.getFont("explorer");
+
+    setStyleSheet(styleHelper.getSearchPanelStyle(bgColor, fgColor, selectionBg, selectionFg,
+                                                  hoverBg, primaryColor, explorerFont));
+    m_statusLabel->setFont(explorerFont);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QWidget>
+#include <QAbstractListModel>
+#include <QDir>
+#include <QTimer>
+#include <QVector>
+#include "../../search/ProjectSearch.h"
+
+class QLineEdit;
+class QCheckBox;
+class QLabel;
+class QListView;
+class TrigramIndex;
+
+/*
+ * Flat list of search matches. Rows are only ever appended while a search
+ * runs, and every row has the same height, so the view can stay virtualized
+ * with hundreds of thousands of entries.
+ */
+class SearchResultModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    enum Roles
+    {
+        FilePathRole = Qt::UserRole + 1,
+        LineRole,
+        ColumnRole
+    };
+
+    explicit SearchResultModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    void setRootPath(const QString &rootPath);
+    void appendMatches(const QVector<SearchMatch> &matches);
+    void clear();
+
+private:
+    QVector<SearchMatch> m_matches;
+    QDir m_root;
+};
+
+class SearchPanel : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit SearchPanel(QWidget *parent = nullptr);
+
+    void setRootPath(const QString &rootPath);
+    // Optional index used to narrow literal searches down to candidate files
+    void setTrigramIndex(TrigramIndex *index) { m_index = index; }
+    void focusQuery();
+
+signals:
+    void matchActivated(const QString &filePath, int line, int column);
+
+public slots:
+    void applyTheme();
+
+private slots:
+    void startSearch();
+    void onMatchesFound(const QVector<SearchMatch> &matches);
+    void onSearchFinished(int matchCount, int fileCount, bool truncated);
+    void onResultActivated(const QModelIndex &index);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    QLineEdit *m_queryEdit;
+    QCheckBox *m_caseCheck;
+    QCheckBox *m_regexCheck;
+    QLabel *m_statusLabel;
+    QListView *m_resultsView;
+    SearchResultModel *m_model;
+    ProjectSearch *m_search;
+    TrigramIndex *m_index;
+    QTimer m_debounceTimer;
+    QString m_rootPath;
+};
@@ -1,10 +1,14 @@
 #include "Sidebar.h"
 #include "CustomTreeView.h"
-#include "FileIconProvider.h"
+#include "ProjectTreeModel.h"
+#include "SearchPanel.h"
+#include "../../search/TrigramIndex.h"
 #include "../../themes/Theme.h"
 #include "../../styles/StyleHelper.h"
 #include "../../logging/VoltLogger.h"
+#include "../../logging/VoltTrace.h"
 #include "../utils/IconUtils.h"
+#include "../utils/IconAtlas.h"
 #include "../components/CustomTabBar.h"
 #include "../components/CustomTabWidget.h"
 
@@ -34,15 +38,14 @@ Sidebar::Sidebar(QWidget *parent)
       m_stackedWidget(nullptr),
       m_explorerWidget(nullptr),
       m_treeView(new CustomTreeView(this)),
-      m_fileSystemModel(nullptr),
-      m_fileIconProvider(new FileIconProvider()),
+      m_projectModel(nullptr),
       m_welcomeWidget(nullptr),
       m_welcomeLabel(nullptr),
       m_welcomeOpenFolderButton(nullptr),
-      m_searchWidget(nullptr),
-      m_searchLabel(nullptr),
-      m_explorerTopBar(nullptr),
-      m_font("icons-carbon")
+      m_searchPanel(nullptr),
+      m_trigramIndex(new TrigramIndex(this)),
+      m_searchIndexEnabled(true),
+      m_explorerTopBar(nullptr)
 {
     setTitleBarWidget(new QWidget());
     setupUI();
@@ -93,66 +96,12 @@ void Sidebar::createExplorerTab()
     m_mainLayout->setSpacing(0);
 
     qreal devicePixelRatio = this->devicePixelRatio();
-    // Create high-DPI pixmap for crisp icons
-    QPixmap newFileIcon(QSize(24, 24) * devicePixelRatio);
-    QPixmap collapseAllIcon(QSize(24, 24) * devicePixelRatio);
-
-    newFileIcon.setDevicePixelRatio(devicePixelRatio);
-    newFileIcon.fill(Qt::transparent);
-    {
-        QPainter painter(&newFileIcon);
-        painter.setRenderHint(QPainter::Antialiasing, true);
-        painter.setRenderHint(QPainter::TextAntialiasing, true);
-        painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
-
-        QFont carbonFont = m_font;
-        carbonFont.setPixelSize(18);
-        carbonFont.setHintingPreference(QFont::PreferNoHinting);
-
-        painter.setFont(carbonFont);
-        painter.setPen(QColor("#CCCCCC"));
-
-        QChar newFileChar = Theme::instance().getCarbonIconChar("symbol-file");
-        if (!newFileChar.isNull())
-        {
-            VOLT_DEBUG_F("Using Carbon icon for new file: U+%1 char: %2", QString::number(newFileChar.unicode(), 16).rightJustified(4, '0').toUpper().append(" ").append(newFileChar));
-            QRect iconRect = newFileIcon.rect();
-            if (devicePixelRatio > 1.0)
-            {
-                iconRect = QRect(0, 0, 24, 24);
-            }
-            painter.drawText(iconRect, Qt::AlignCenter | Qt::AlignVCenter, newFileChar);
-        }
-    }
-
-    // collaspe all icon
-    collapseAllIcon.setDevicePixelRatio(devicePixelRatio);
-    collapseAllIcon.fill(Qt::transparent);
-    {
-        QPainter painter(&collapseAllIcon);
-        painter.setRenderHint(QPainter::Antialiasing, true);
-        painter.setRenderHint(QPainter::TextAntialiasing, true);
-        painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
-
-        QFont carbonFont = m_font;
-        carbonFont.setPixelSize(18);
-        carbonFont.setHintingPreference(QFont::PreferNoHinting);
-
-        painter.setFont(carbonFont);
-        painter.setPen(QColor("#CCCCCC"));
-
-        QChar collapseAllChar = Theme::instance().getCarbonIconChar("chevron-up");
-        if (!collapseAllChar.isNull())
-        {
-            VOLT_DEBUG_F("Using Carbon icon for collapse all: U+%1 char: %2", QString::number(collapseAllChar.unicode(), 16).rightJustified(4, '0').toUpper().append(" ").append(collapseAllChar));
-            QRect iconRect = collapseAllIcon.rect();
-            if (devicePixelRatio > 1.0)
-            {
-                iconRect = QRect(0, 0, 24, 24);
-            }
-            painter.drawText(iconRect, Qt::AlignCenter | Qt::AlignVCenter, collapseAllChar);
-        }
-    }
+    // High-DPI glyph pixmaps for crisp icons, rasterized once by the shared atlas
+    IconAtlas &atlas = IconAtlas::instance();
+    QPixmap newFileIcon = atlas.pixmap(Theme::instance().getCarbonIconChar("symbol-file"), QColor("#CCCCCC"), 18,
+                                       QSize(24, 24), devicePixelRatio);
+    QPixmap collapseAllIcon = atlas.pixmap(Theme::instance().getCarbonIconChar("chevron-up"), QColor("#CCCCCC"), 18,
+                                           QSize(24, 24), devicePixelRatio);
     m_createFileButton = new IconButton("Create New File", this);
     m_collapseButton = new IconButton("Collapse All", this);
 
@@ -181,8 +130,6 @@ void Sidebar::createExplorerTab()
     m_treeView->setHeaderHidden(true);
     m_treeView->setRootIsDecorated(true);
     m_treeView->setAlternatingRowColors(false);
-    m_treeView->setSortingEnabled(true);
-    m_treeView->sortByColumn(0, Qt::AscendingOrder);
     m_treeView->setExpandsOnDoubleClick(false);
     m_treeView->setContextMenuPolicy(Qt::CustomContextMenu);
     m_treeView->setIndentation(16);
@@ -210,32 +157,8 @@ void Sidebar::createExplorerTab()
     connect(m_collapseButton, &QPushButton::clicked, this, &Sidebar::collapseAll);
     connect(m_createFileButton, &QPushButton::clicked, this, &Sidebar::createNewFile);
 
-    QPixmap folderIcon(QSize(24, 24) * devicePixelRatio);
-    folderIcon.setDevicePixelRatio(devicePixelRatio);
-    folderIcon.fill(Qt::transparent);
-    {
-        QPainter painter(&folderIcon);
-        painter.setRenderHint(QPainter::Antialiasing, true);
-        painter.setRenderHint(QPainter::TextAntialiasing, true);
-        painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
-
-        QFont carbonFont = m_font;
-        carbonFont.setPixelSize(18);
-        carbonFont.setHintingPreference(QFont::PreferNoHinting);
-        painter.setFont(carbonFont);
-        painter.setPen(QColor("#CCCCCC"));
-
-        QChar folderChar = Theme::instance().getCarbonIconChar("symbol-folder");
-        if (!folderChar.isNull())
-        {
-            QRect iconRect = folderIcon.rect();
-            if (devicePixelRatio > 1.0)
-            {
-                iconRect = QRect(0, 0, 24, 24);
-            }
-            painter.drawText(iconRect, Qt::AlignCenter | Qt::AlignVCenter, folderChar);
-        }
-    }
+    QPixmap folderIcon = atlas.pixmap(Theme::instance().getCarbonIconChar("symbol-folder"), QColor("#CCCCCC"), 18,
+                                      QSize(24, 24), devicePixelRatio);
 
     m_tabWidget->addTab(m_explorerWidget, QIcon(folderIcon), "");
     m_tabWidget->setTabToolTip(0, "Explorer");
@@ -245,49 +168,17 @@ void Sidebar::createExplorerTab()
 
 void Sidebar::createSearchTab()
 {
-    // Create the search widget
-    m_searchWidget = new QWidget();
-    QVBoxLayout *searchLayout = new QVBoxLayout(m_searchWidget);
-
-    m_searchLabel = new QLabel("Search functionality coming soon...", m_searchWidget);
-    m_searchLabel->setAlignment(Qt::AlignCenter);
-    m_searchLabel->setWordWrap(true);
-
-    searchLayout->addStretch();
-    searchLayout->addWidget(m_searchLabel);
-    searchLayout->addStretch();
+    // Create the search panel
+    m_searchPanel = new SearchPanel();
+    m_searchPanel->setTrigramIndex(m_trigramIndex);
+    connect(m_searchPanel, &SearchPanel::matchActivated, this, &Sidebar::searchMatchActivated);
 
     // Create high-DPI pixmap for crisp icons
-    qreal devicePixelRatio = this->devicePixelRatio();
-    QPixmap searchIcon(QSize(24, 24) * devicePixelRatio);
-    searchIcon.setDevicePixelRatio(devicePixelRatio);
-    searchIcon.fill(Qt::transparent);
-    QPainter painter(&searchIcon);
-    painter.setRenderHint(QPainter::Antialiasing, true);
-    painter.setRenderHint(QPainter::TextAntialiasing, true);
-    painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
-
-    QFont carbonFont = m_font;
-    carbonFont.setPixelSize(18);
-    carbonFont.setHintingPreference(QFont::PreferNoHinting);
-    painter.setFont(carbonFont);
-    painter.setPen(QColor("#CCCCCC"));
-
-    QChar searchChar = Theme::instance().getCarbonIconChar("search");
-    if (!searchChar.isNull())
-    {
-        VOLT_DEBUG_F("Using Carbon icon for search: U+%1 char: %2", QString::number(searchChar.unicode(), 16).rightJustified(4, '0').toUpper().append(" ").append(searchChar));
-        // Use proper bounding rectangle for centering
-        QRect iconRect = searchIcon.rect();
-        if (devicePixelRatio > 1.0)
-        {
-            iconRect = QRect(0, 0, 24, 24);
-        }
-        painter.drawText(iconRect, Qt::AlignCenter | Qt::AlignVCenter, searchChar);
-    }
+    QPixmap searchIcon = IconAtlas::instance().pixmap(Theme::instance().getCarbonIconChar("search"), QColor("#CCCCCC"),
+                                                      18, QSize(24, 24), devicePixelRatio());
 
     // Add to tab widget
-    m_tabWidget->addTab(m_searchWidget, QIcon(searchIcon), "");
+    m_tabWidget->addTab(m_searchPanel, QIcon(searchIcon), "");
     m_tabWidget->setTabToolTip(1, "Search");
 }
 
@@ -304,32 +195,8 @@ void Sidebar::createSourceControlTab()
     sourceControlLayout->addWidget(sourceControlLabel);
     sourceControlLayout->addStretch();
 
-    qreal devicePixelRatio = this->devicePixelRatio();
-    QPixmap sourceControlIcon(QSize(24, 24) * devicePixelRatio);
-    sourceControlIcon.setDevicePixelRatio(devicePixelRatio);
-    sourceControlIcon.fill(Qt::transparent);
-    QPainter painter(&sourceControlIcon);
-    painter.setRenderHint(QPainter::Antialiasing, true);
-    painter.setRenderHint(QPainter::TextAntialiasing, true);
-    painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
-
-    QFont carbonFont = m_font;
-    carbonFont.setPixelSize(18);
-    carbonFont.setHintingPreference(QFont::PreferNoHinting);
-    painter.setFont(carbonFont);
-    painter.setPen(QColor("#CCCCCC"));
-
-    QChar sourceControlChar = Theme::instance().getCarbonIconChar("source-control");
-    if (!sourceControlChar.isNull())
-    {
-
-        QRect iconRect = sourceControlIcon.rect();
-        if (devicePixelRatio > 1.0)
-        {
-            iconRect = QRect(0, 0, 24, 24);
-        }
-        painter.drawText(iconRect, Qt::AlignCenter | Qt::AlignVCenter, sourceControlChar);
-    }
+    QPixmap sourceControlIcon = IconAtlas::instance().pixmap(Theme::instance().getCarbonIconChar("source-control"),
+                                                             QColor("#CCCCCC"), 18, QSize(24, 24), devicePixelRatio());
 
     m_tabWidget->addTab(sourceControlWidget, QIcon(sourceControlIcon), "");
     m_tabWidget->setTabToolTip(2, "Source Control");
@@ -337,22 +204,17 @@ void Sidebar::createSourceControlTab()
 
 void Sidebar::setupFileSystemModel()
 {
-    m_fileSystemModel = new QFileSystemModel(this);
-    m_fileSystemModel->setRootPath("");
-
-    // Set custom icon provider
-    m_fileSystemModel->setIconProvider(m_fileIconProvider);
-
-    // Set filters to show all files and folders
-    m_fileSystemModel->setFilter(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::AllDirs);
-
-    // Connect model to tree view
-    m_treeView->setModel(m_fileSystemModel);
-
-    // Hide extra columns (only show name)
-    m_treeView->hideColumn(1); // Size
-    m_treeView->hideColumn(2); // Type
-    m_treeView->hideColumn(3); // Date Modified
+    // Folders are listed and sorted on demand, nothing is read until a root is set
+    m_projectModel = new ProjectTreeModel(this);
+    m_treeView->setModel(m_projectModel);
+
+    // Only expanded folders are watched for changes
+    connect(m_treeView, &QTreeView::expanded, this, [this](const QModelIndex &index) {
+        m_projectModel->setWatched(index, true);
+    });
+    connect(m_treeView, &QTreeView::collapsed, this, [this](const QModelIndex &index) {
+        m_projectModel->setWatched(index, false);
+    });
 
     // Connect tree view signals
     connect(m_treeView, &QTreeView::doubleClicked, this, &Sidebar::onItemDoubleClicked);
@@ -362,6 +224,7 @@ void Sidebar::setupFileSystemModel()
 
 void Sidebar::setRootPath(const QString &path)
 {
+    VOLT_TRACE_SCOPE("Sidebar::setRootPath");
     if (path.isEmpty())
     {
         showWelcomeScreen();
@@ -378,14 +241,15 @@ void Sidebar::setRootPath(const QString &path)
     m_currentRootPath = dir.absolutePath();
 
     // Set the model root path
-    QModelIndex rootIndex = m_fileSystemModel->setRootPath(m_currentRootPath);
-    m_treeView->setRootIndex(rootIndex);
+    m_projectModel->setRootPath(m_currentRootPath);
 
     // Update path display
     m_pathEdit->setText(m_currentRootPath);
-
-    // Expand the root
-    m_treeView->expand(rootIndex);
+    m_searchPanel->setRootPath(m_currentRootPath);
+    if (m_searchIndexEnabled)
+    {
+        m_trigramIndex->setRootPath(m_currentRootPath);
+    }
 
     VoltLogger::instance().info("Project Explorer root set to: %1", m_currentRootPath);
     emit folderChanged(m_currentRootPath);
@@ -417,6 +281,17 @@ QString Sidebar::currentRootPath() const
     return m_currentRootPath;
 }
 
+void Sidebar::setSearchIndexEnabled(bool enabled)
+{
+    m_searchIndexEnabled = enabled;
+    m_trigramIndex->setRootPath(enabled ? m_currentRootPath : QString());
+}
+
+void Sidebar::notifyFileSaved(const QString &filePath)
+{
+    m_trigramIndex->markDirty(filePath);
+}
+
 void Sidebar::openFolder()
 {
     QString folderPath = QFileDialog::getExistingDirectory(
@@ -442,15 +317,14 @@ void Sidebar::onItemDoubleClicked(const QModelIndex &index)
         return;
     }
 
-    QString filePath = m_fileSystemModel->filePath(index);
-    QFileInfo fileInfo(filePath);
+    QString filePath = m_projectModel->filePath(index);
 
-    if (fileInfo.isFile())
+    if (!m_projectModel->isDir(index))
     {
         VoltLogger::instance().info("Project Explorer: File double-clicked: %1", filePath);
         emit fileDoubleClicked(filePath);
     }
-    else if (fileInfo.isDir())
+    else
     {
         // Toggle expand/collapse for folders
         if (m_treeView->isExpanded(index))
@@ -474,8 +348,7 @@ void Sidebar::onSelectionChanged(const QModelIndex &current, const QModelIndex &
         return;
     }
 
-    QString filePath = m_fileSystemModel->filePath(current);
-    QFileInfo fileInfo(filePath);
+    QString filePath = m_projectModel->filePath(current);
 
     VOLT_TRACE_F("Project Explorer: Selection changed to: %1", filePath);
 }
@@ -519,12 +392,6 @@ void Sidebar::applyTheme()
     QString labelStyle = styleHelper.getLabelStyle(fgColor);
     m_welcomeLabel->setFont(explorerFont);
     m_welcomeLabel->setStyleSheet(labelStyle);
-
-    if (m_searchLabel)
-    {
-        m_searchLabel->setFont(explorerFont);
-        m_searchLabel->setStyleSheet(labelStyle);
-    }
 }
 
 void Sidebar::createNewFile()
@@ -643,7 +510,7 @@ void Sidebar::createNewFile()
                                  QString("File '%1' created successfully!").arg(fileName));
 
         // Refresh the tree view to show the new file
-        m_fileSystemModel->dataChanged(m_fileSystemModel->index(0, 0), m_fileSystemModel->index(m_fileSystemModel->rowCount() - 1, 0));
+        m_projectModel->refreshDirectory(QFileInfo(filePath).absolutePath());
     }
     else
     {
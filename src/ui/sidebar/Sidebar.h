@@ -2,7 +2,6 @@
 
 #include <QDockWidget>
 #include <QTreeView>
-#include <QFileSystemModel>
 #include <QVBoxLayout>
 #include <QLabel>
 #include <QLineEdit>
@@ -17,7 +16,9 @@
 #include "../components/CustomTabWidget.h"
 #include "../components/CustomTabBar.h"
 
-class FileIconProvider;
+class ProjectTreeModel;
+class SearchPanel;
+class TrigramIndex;
 
 class Sidebar : public QDockWidget
 {
@@ -29,17 +30,20 @@ public:
 
     void setRootPath(const QString &path);
     QString currentRootPath() const;
+    void setSearchIndexEnabled(bool enabled);
 
 public slots:
     void applyTheme();
     void openFolder();
     void collapseAll();
     void createNewFile();
+    void notifyFileSaved(const QString &filePath);
 
 signals:
     void fileDoubleClicked(const QString &filePath);
     void folderChanged(const QString &folderPath);
     void fileCreated(const QString &filePath);
+    void searchMatchActivated(const QString &filePath, int line, int column);
 
 private slots:
     void onItemDoubleClicked(const QModelIndex &index);
@@ -73,8 +77,7 @@ private:
 
     // Tree View
     QTreeView *m_treeView;
-    QFileSystemModel *m_fileSystemModel;
-    FileIconProvider *m_fileIconProvider;
+    ProjectTreeModel *m_projectModel;
 
     // Welcome Screen
     QWidget *m_welcomeWidget;
@@ -82,10 +85,9 @@ private:
     FilledColorButton *m_welcomeOpenFolderButton;
 
     // Other Tab Components
-    QWidget *m_searchWidget;
-    QLabel *m_searchLabel;
+    SearchPanel *m_searchPanel;
+    TrigramIndex *m_trigramIndex;
+    bool m_searchIndexEnabled;
 
     QString m_currentRootPath;
-
-    QFont m_font;
 };
@@ -21,7 +21,18 @@ void StatusBar::setupLabels()
     encodingLabel = new QLabel("UTF-8", this);
     lineEndingLabel = new QLabel("CRLF", this);
 
+    loadProgressBar = new QProgressBar(this);
+    loadProgressBar->setRange(0, 100);
+    loadProgressBar->setFixedWidth(180);
+    loadProgressBar->setTextVisible(true);
+    loadProgressBar->setVisible(false);
+
+    largeFileLabel = new QLabel("Large File Mode", this);
+    largeFileLabel->setVisible(false);
+
     // add items to the right side
+    addPermanentWidget(loadProgressBar);
+    addPermanentWidget(largeFileLabel);
     addPermanentWidget(cursorPositionLabel);
     addPermanentWidget(languageLabel);
     addPermanentWidget(encodingLabel);
@@ -31,6 +42,7 @@ void StatusBar::setupLabels()
     languageLabel->setToolTip("Select Language Mode");
     encodingLabel->setToolTip("Select Encoding");
     lineEndingLabel->setToolTip("Select End of Line Sequence");
+    largeFileLabel->setToolTip("Syntax highlighting, folding and the minimap are disabled for this file");
 }
 
 void StatusBar::applyTheme()
@@ -55,6 +67,7 @@ void StatusBar::applyTheme()
     if (languageLabel) languageLabel->setFont(statusFont);
     if (encodingLabel) encodingLabel->setFont(statusFont);
     if (lineEndingLabel) lineEndingLabel->setFont(statusFont);
+    if (largeFileLabel) largeFileLabel->setFont(statusFont);
     
     // Create dynamic stylesheet from JSON values
     QString stylesheet = QString(R"(
@@ -82,6 +95,16 @@ void StatusBar::applyTheme()
         QStatusBar QLabel:hover {
             background-color: %10;
         }
+        QStatusBar QProgressBar {
+            color: %2;
+            background: transparent;
+            border: 1px solid %2;
+            max-height: 10px;
+            font-size: 7pt;
+        }
+        QStatusBar QProgressBar::chunk {
+            background-color: %2;
+        }
     )")
     .arg(bgColor.name())                    
     .arg(fgColor.name())                    
@@ -132,3 +155,30 @@ void StatusBar::updateLineEnding(const QString &lineEnding)
 {
     lineEndingLabel->setText(lineEnding);
 }
+
+/*
+    * Shows the progress of a file being streamed into an editor.
+    * @param fileName The file being loaded.
+    * @param percent Load progress, the indicator hides itself at 100.
+*/
+void StatusBar::updateLoadProgress(const QString &fileName, int percent)
+{
+    if (percent >= 100)
+    {
+        loadProgressBar->setVisible(false);
+        return;
+    }
+
+    loadProgressBar->setFormat(QString("Loading %1 %p%").arg(fileName));
+    loadProgressBar->setValue(percent);
+    loadProgressBar->setVisible(true);
+}
+
+/*
+    * Shows or hides the large file mode indicator for the current editor.
+    * @param active Whether the current editor runs in large file mode.
+*/
+void StatusBar::updateLargeFileMode(bool active)
+{
+    largeFileLabel->setVisible(active);
+}
@@ -3,6 +3,7 @@
 
 #include <QStatusBar>
 #include <QLabel>
+#include <QProgressBar>
 
 class StatusBar : public QStatusBar
 {
@@ -17,6 +18,8 @@ public slots:
     void updateLanguage(const QString &language);
     void updateEncoding(const QString &encoding);
     void updateLineEnding(const QString &lineEnding);
+    void updateLoadProgress(const QString &fileName, int percent);
+    void updateLargeFileMode(bool active);
     void applyTheme();  // Apply theme from JSON
 
 private:
@@ -24,6 +27,8 @@ private:
     QLabel *languageLabel;
     QLabel *encodingLabel;
     QLabel *lineEndingLabel;
+    QProgressBar *loadProgressBar;
+    QLabel *largeFileLabel;
 
     void setupLabels();
 
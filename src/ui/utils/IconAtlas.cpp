@@ -0,0 +1,113 @@
+#include "IconAtlas.h"
+#include "../../themes/Theme.h"
+#include "../../logging/VoltLogger.h"
+
+#include <QPainter>
+#include <QtMath>
+
+IconAtlas &IconAtlas::instance()
+{
+    static IconAtlas instance;
+    return instance;
+}
+
+IconAtlas::IconAtlas()
+    : m_font("icons-carbon"),
+      m_shelfX(0),
+      m_shelfY(0),
+      m_shelfHeight(0),
+      m_themeGeneration(0)
+{
+    m_font.setHintingPreference(QFont::PreferNoHinting);
+}
+
+void IconAtlas::draw(QPainter *painter, const QRect &rect, QChar glyph, const QColor &color, int pixelSize)
+{
+    qreal devicePixelRatio = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+    const Slot &slot = slotFor(glyph, color, pixelSize, devicePixelRatio);
+
+    //* The source rect is in device pixels, the target in logical ones, so the blit is 1:1 *//
+    QRectF target(0, 0, slot.source.width() / devicePixelRatio, slot.source.height() / devicePixelRatio);
+    target.moveCenter(QRectF(rect).center());
+    painter->drawPixmap(target, m_pages[size_t(slot.page)], QRectF(slot.source));
+}
+
+QPixmap IconAtlas::pixmap(QChar glyph, const QColor &color, int pixelSize, const QSize &size, qreal devicePixelRatio)
+{
+    QPixmap result(size * devicePixelRatio);
+    result.setDevicePixelRatio(devicePixelRatio);
+    result.fill(Qt::transparent);
+    if (glyph.isNull())
+    {
+        return result;
+    }
+    {
+        QPainter painter(&result);
+        draw(&painter, QRect(QPoint(0, 0), size), glyph, color, pixelSize);
+    }
+    return result;
+}
+
+const IconAtlas::Slot &IconAtlas::slotFor(QChar glyph, const QColor &color, int pixelSize, qreal devicePixelRatio)
+{
+    quint64 themeGeneration = Theme::instance().generation();
+    if (themeGeneration != m_themeGeneration)
+    {
+        m_slots.clear();
+        m_pages.clear();
+        m_shelfX = m_shelfY = m_shelfHeight = 0;
+        m_themeGeneration = themeGeneration;
+    }
+
+    Key key{glyph.unicode(), color.rgba(), pixelSize, qRound(devicePixelRatio * 100)};
+    auto it = m_slots.constFind(key);
+    if (it != m_slots.constEnd())
+    {
+        return it.value();
+    }
+
+    //* One pixel of padding keeps antialiased edges from bleeding into neighbours *//
+    int cellSize = qCeil(pixelSize * devicePixelRatio) + 2;
+    int page = 0;
+    QRect cell = allocate(cellSize, page);
+
+    QPainter painter(&m_pages[size_t(page)]);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(cell, Qt::transparent);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setRenderHint(QPainter::TextAntialiasing, true);
+
+    QFont font = m_font;
+    font.setPixelSize(qCeil(pixelSize * devicePixelRatio));
+    painter.setFont(font);
+    painter.setPen(color);
+    painter.drawText(cell, Qt::AlignCenter, QString(glyph));
+
+    return m_slots.insert(key, Slot{page, cell}).value();
+}
+
+//* Shelf packing: cells fill a row left to right, a full row opens the next shelf or page *//
+QRect IconAtlas::allocate(int cellSize, int &page)
+{
+    if (m_pages.empty() || m_shelfX + cellSize > PageSize)
+    {
+        m_shelfY += m_shelfHeight;
+        m_shelfX = 0;
+        m_shelfHeight = 0;
+    }
+    if (m_pages.empty() || m_shelfY + cellSize > PageSize)
+    {
+        QPixmap newPage(PageSize, PageSize);
+        newPage.fill(Qt::transparent);
+        m_pages.push_back(newPage);
+        m_shelfX = m_shelfY = m_shelfHeight = 0;
+        VOLT_DEBUG_F("IconAtlas: page %1 allocated", QString::number(m_pages.size()));
+    }
+
+    page = int(m_pages.size()) - 1;
+    QRect cell(m_shelfX, m_shelfY, cellSize, cellSize);
+    m_shelfX += cellSize;
+    m_shelfHeight = qMax(m_shelfHeight, cellSize);
+    return cell;
+}
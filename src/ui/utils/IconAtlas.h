@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QColor>
+#include <QFont>
+#include <QHash>
+#include <QPixmap>
+#include <QRect>
+#include <vector>
+
+class QPainter;
+
+/*
+ * Shared cache of rasterized icon font glyphs.
+ *
+ * Each (glyph, color, pixel size, device pixel ratio) combination is drawn
+ * once into a shelf-packed atlas page; painting an icon afterwards is a
+ * pixmap blit instead of shaping the glyph again. The atlas is dropped when
+ * the theme generation changes, since icon colors come from the theme.
+ */
+class IconAtlas
+{
+public:
+    static IconAtlas &instance();
+
+    // Draws the glyph centered in rect, at the painter's device pixel ratio
+    void draw(QPainter *painter, const QRect &rect, QChar glyph, const QColor &color, int pixelSize);
+
+    // Standalone pixmap of the glyph centered in size, for QIcon and button use
+    QPixmap pixmap(QChar glyph, const QColor &color, int pixelSize, const QSize &size, qreal devicePixelRatio);
+
+    static constexpr int PageSize = 512;
+
+private:
+    struct Key
+    {
+        char16_t glyph;
+        QRgb color;
+        int pixelSize;
+        int scaledRatio;
+
+        bool operator==(const Key &other) const
+        {
+            return glyph == other.glyph && color == other.color && pixelSize == other.pixelSize
+                   && scaledRatio == other.scaledRatio;
+        }
+    };
+
+    struct Slot
+    {
+        int page;
+        QRect source;
+    };
+
+    friend size_t qHash(const Key &key, size_t seed)
+    {
+        return qHashMulti(seed, key.glyph, key.color, key.pixelSize, key.scaledRatio);
+    }
+
+    IconAtlas();
+    const Slot &slotFor(QChar glyph, const QColor &color, int pixelSize, qreal devicePixelRatio);
+    QRect allocate(int cellSize, int &page);
+
+    QFont m_font;
+    QHash<Key, Slot> m_slots;
+    std::vector<QPixmap> m_pages;
+    int m_shelfX;
+    int m_shelfY;
+    int m_shelfHeight;
+    quint64 m_themeGeneration;
+};